@@ -0,0 +1,37 @@
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "CellIndex.hpp"
+#include "Generator.hpp"
+#include "Solver.hpp"
+
+std::unique_ptr<TCSolver::Config> TCSolver::Bench::Generate(
+	std::shared_ptr<const Catalog> catalog,
+	const PuzzleSpec& spec
+) {
+	const int32_t cellCount = CellIndex::GetCellCount(spec.gridSize);
+	if (spec.terminalCount > cellCount) return nullptr;
+
+	// SplitMix64 over a counter is a complete generator on its own, and keeps puzzles identical across platforms
+	uint64_t state = spec.seed;
+	auto next = [&state]() { return Solver::SplitMix64(state++); };
+	auto uniform = [&next](uint64_t bound) { return next() % bound; };
+
+	std::vector<int32_t> cells(cellCount);
+	std::iota(cells.begin(), cells.end(), 0);
+	for (int32_t i = cellCount - 1; i > 0; --i) std::swap(cells[i], cells[uniform(i + 1)]);
+
+	const int32_t aspectCount = catalog->GetAspects().size();
+	std::vector<Node> nodes;
+	for (int32_t i = 0; i < cellCount; ++i) {
+		Hex position = CellIndex::ToHex(cells[i]);
+		if (i < spec.terminalCount) {
+			nodes.emplace_back(position, static_cast<int32_t>(uniform(aspectCount)));
+		} else if (static_cast<double>(next() >> 11) * 0x1.0p-53 < spec.holeDensity) {
+			nodes.emplace_back(position, -1);
+		}
+	}
+
+	return std::make_unique<Config>(std::move(catalog), spec.gridSize, std::move(nodes));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "Catalog.hpp"
+#include "Config.hpp"
+
+/**
+ * Deterministic random puzzles for benchmarking.
+ */
+namespace TCSolver::Bench {
+
+struct PuzzleSpec {
+public:
+	int32_t gridSize;
+	int32_t terminalCount;
+	// Chance that each cell left over after placing the terminals is a hole
+	double holeDensity;
+	uint64_t seed;
+};
+
+/**
+ * Places spec.terminalCount terminals with uniformly random aspects from catalog on distinct random cells, then turns
+ * each remaining cell into a hole with probability spec.holeDensity. The same spec and catalog always give the same
+ * puzzle. Returns null if the grid has fewer cells than terminals.
+ */
+std::unique_ptr<Config> Generate(std::shared_ptr<const Catalog> catalog, const PuzzleSpec& spec);
+
+}
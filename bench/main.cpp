@@ -0,0 +1,411 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Arena.hpp"
+#include "AStar.hpp"
+#include "CellIndex.hpp"
+#include "DijkstraSteiner.hpp"
+#include "Dispatch.hpp"
+#include "DreyfusWagner.hpp"
+#include "Generator.hpp"
+#include "Graph.hpp"
+#include "Heuristic.hpp"
+
+// Every operator new in the process goes through these, so the harness can report each run's peak heap use
+
+namespace {
+
+std::atomic<size_t> allocatedBytes = 0;
+std::atomic<size_t> peakBytes = 0;
+
+// Room in front of each block for its size, keeping the block itself suitably aligned
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+void* Allocate(size_t size) {
+	void* block = std::malloc(size + HEADER_SIZE);
+	if (!block) throw std::bad_alloc();
+	*static_cast<size_t*>(block) = size;
+
+	size_t current = allocatedBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	size_t peak = peakBytes.load(std::memory_order_relaxed);
+	while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed));
+
+	return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+void Deallocate(void* pointer) noexcept {
+	if (!pointer) return;
+	void* block = static_cast<char*>(pointer) - HEADER_SIZE;
+	allocatedBytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+	std::free(block);
+}
+
+}
+
+void* operator new(size_t size) { return Allocate(size); }
+void* operator new[](size_t size) { return Allocate(size); }
+void operator delete(void* pointer) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { Deallocate(pointer); }
+void operator delete(void* pointer, size_t) noexcept { Deallocate(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { Deallocate(pointer); }
+
+namespace {
+
+using SolveFunction = std::function<
+	bool(const TCSolver::Graph&, std::vector<TCSolver::Solver::Placement>&, const TCSolver::Solver::Options&)
+>;
+
+/**
+ * A solver as the harness sees it. New engines only need an entry in GetEngines.
+ */
+struct Engine {
+public:
+	std::string_view name;
+	int32_t minTerminals;
+	int32_t maxTerminals;
+	SolveFunction solve;
+	// With --check, an engine whose cost this one has to match on every puzzle both solve, and with bLeaner, whose
+	// peak memory this one has to stay below on every puzzle shape
+	std::string_view reference = {};
+	bool bLeaner = false;
+};
+
+/**
+ * The two terminals of a two-terminal graph, in cell order so runs do not depend on hash order.
+ */
+std::pair<TCSolver::Hex, TCSolver::Hex> GetEnds(const TCSolver::Graph& graph) {
+	std::vector<TCSolver::Hex> ends(graph.GetTerminals().begin(), graph.GetTerminals().end());
+	std::sort(ends.begin(), ends.end(), [](const TCSolver::Hex& lhs, const TCSolver::Hex& rhs) {
+		return TCSolver::CellIndex::FromHex(lhs) < TCSolver::CellIndex::FromHex(rhs);
+	});
+	return {ends[0], ends[1]};
+}
+
+std::vector<Engine> GetEngines() {
+	using namespace TCSolver;
+
+	auto solveAStar = [](bool bBidirectional) -> SolveFunction {
+		return [bBidirectional](
+			const Graph& graph,
+			std::vector<Solver::Placement>& placements,
+			const Solver::Options& options
+		) {
+			auto [start, end] = GetEnds(graph);
+			std::vector<AStar::State> path;
+			bool bSolved = bBidirectional
+				? AStar::SolveBidirectional(graph, start, end, path, options)
+				: AStar::Solve(graph, start, end, path, options);
+			for (const AStar::State& state : path) {
+				if (!graph.IsTerminal(state.position)) placements.push_back({state.position, state.aspectId});
+			}
+			return bSolved;
+		};
+	};
+
+	// Without the lower bound, which the bench does not report
+	auto solveDijkstraSteiner = [](
+		const Graph& graph,
+		std::vector<Solver::Placement>& placements,
+		const Solver::Options& options
+	) {
+		return DijkstraSteiner::Solve(graph, placements, options);
+	};
+
+	auto solveDreyfusWagnerBounded = [](
+		const Graph& graph,
+		std::vector<Solver::Placement>& placements,
+		const Solver::Options& options
+	) {
+		Solver::Options boundedOptions = options;
+		boundedOptions.bBoundedMemory = true;
+		return DreyfusWagner::Solve(graph, placements, boundedOptions);
+	};
+
+	return {
+		{"astar", 2, 2, solveAStar(false)},
+		{"astar-bidirectional", 2, 2, solveAStar(true)},
+		{"dijkstra-steiner", 2, Solver::MAX_EXACT_TERMINALS, solveDijkstraSteiner},
+		{"dreyfus-wagner", 2, Solver::MAX_EXACT_TERMINALS, DreyfusWagner::Solve, "dijkstra-steiner"},
+		{"dreyfus-wagner-bounded", 2, Solver::MAX_EXACT_TERMINALS, solveDreyfusWagnerBounded, "dreyfus-wagner", true},
+		{"heuristic", 2, std::numeric_limits<int32_t>::max(), Heuristic::Solve},
+	};
+}
+
+struct Settings {
+public:
+	uint64_t seed = 1;
+	int32_t puzzleCount = 3;
+	int32_t repeatCount = 5;
+	int32_t minGridSize = 1;
+	int32_t maxGridSize = TCSolver::CellIndex::MAX_GRID_SIZE;
+	int32_t minTerminals = 2;
+	int32_t maxTerminals = TCSolver::Solver::MAX_EXACT_TERMINALS;
+	std::vector<double> holeDensities = {0.0, 0.15, 0.3};
+	std::vector<std::string> catalogFiles;
+	std::vector<std::string> engineNames;
+	std::chrono::milliseconds timeLimit = std::chrono::milliseconds(1000);
+	// Whether every solved board is checked with Solver::IsValidTree, and every engine against its reference, failing
+	// the run if any check does not hold
+	bool bCheck = false;
+};
+
+/**
+ * Everything measured for one engine on one puzzle shape.
+ */
+struct Sample {
+public:
+	std::vector<double> times;
+	std::vector<uint64_t> expanded;
+	size_t peakBytes = 0;
+	int32_t puzzleCount = 0;
+	int32_t solvedCount = 0;
+	int32_t timeoutCount = 0;
+	int32_t invalidCount = 0;
+	int64_t totalCost = 0;
+	// Each puzzle's cost, or -1 if no tree was found
+	std::vector<int32_t> costs;
+};
+
+template<typename T>
+T GetPercentile(std::vector<T> values, double percentile) {
+	if (values.empty()) return T{};
+	std::sort(values.begin(), values.end());
+	size_t rank = static_cast<size_t>(std::ceil(percentile * values.size()));
+	return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+}
+
+/**
+ * Runs an engine on one puzzle settings.repeatCount times, stopping early if it runs out of time.
+ */
+void Measure(const Engine& engine, const TCSolver::Config& config, const Settings& settings, Sample& sample) {
+	TCSolver::Graph graph(config);
+	TCSolver::Solver::AddNodes(graph, config);
+
+	++sample.puzzleCount;
+	sample.costs.push_back(-1);
+	for (int32_t repeat = 0; repeat < settings.repeatCount; ++repeat) {
+		TCSolver::Solver::Counters counters;
+		TCSolver::Solver::Options options;
+		options.counters = &counters;
+		options.deadline = std::chrono::steady_clock::now() + settings.timeLimit;
+
+		std::vector<TCSolver::Solver::Placement> placements;
+		size_t baseline = allocatedBytes.load();
+		peakBytes.store(baseline);
+		TCSolver::Solver::Arena::ForThread().ResetPeakUsage();
+
+		auto start = std::chrono::steady_clock::now();
+		bool bSolved = engine.solve(graph, placements, options);
+		auto end = std::chrono::steady_clock::now();
+
+		if (!bSolved && options.HasExpired()) {
+			++sample.timeoutCount;
+			return;
+		}
+
+		sample.times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+		sample.expanded.push_back(counters.statesExpanded);
+		// Solver containers mostly live in the arena, which keeps its blocks between runs. Arenas of worker threads are
+		// not counted.
+		size_t arenaBytes = TCSolver::Solver::Arena::ForThread().GetPeakUsage();
+		sample.peakBytes = std::max(sample.peakBytes, peakBytes.load() - baseline + arenaBytes);
+
+		if (repeat > 0) continue;
+		if (bSolved) {
+			++sample.solvedCount;
+			sample.totalCost += placements.size();
+			sample.costs.back() = placements.size();
+			if (settings.bCheck && !TCSolver::Solver::IsValidTree(graph, placements)) ++sample.invalidCount;
+		}
+	}
+}
+
+bool ParseRange(std::string_view text, int32_t& low, int32_t& high) {
+	size_t dash = text.find('-');
+	low = std::atoi(std::string(text.substr(0, dash)).c_str());
+	high = dash == std::string_view::npos ? low : std::atoi(std::string(text.substr(dash + 1)).c_str());
+	return low <= high;
+}
+
+std::vector<std::string> Split(std::string_view text) {
+	std::vector<std::string> parts;
+	std::stringstream stream{std::string(text)};
+	for (std::string part; std::getline(stream, part, ',');) {
+		if (!part.empty()) parts.push_back(part);
+	}
+	return parts;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+	Settings settings;
+	bool bValid = true;
+
+	for (int32_t i = 1; i < argc && bValid; ++i) {
+		std::string_view argument = argv[i];
+		if (argument == "--check") {
+			settings.bCheck = true;
+		} else if (i + 1 >= argc) {
+			bValid = false;
+		} else if (argument == "--seed") {
+			settings.seed = std::strtoull(argv[++i], nullptr, 10);
+		} else if (argument == "--puzzles") {
+			settings.puzzleCount = std::max(1, std::atoi(argv[++i]));
+		} else if (argument == "--repeat") {
+			settings.repeatCount = std::max(1, std::atoi(argv[++i]));
+		} else if (argument == "--grid-sizes") {
+			bValid = ParseRange(argv[++i], settings.minGridSize, settings.maxGridSize)
+				&& settings.minGridSize >= 1 && settings.maxGridSize <= TCSolver::CellIndex::MAX_GRID_SIZE;
+		} else if (argument == "--terminals") {
+			bValid = ParseRange(argv[++i], settings.minTerminals, settings.maxTerminals) && settings.minTerminals >= 2;
+		} else if (argument == "--holes") {
+			settings.holeDensities.clear();
+			for (const std::string& density : Split(argv[++i]))
+				settings.holeDensities.push_back(std::atof(density.c_str()));
+		} else if (argument == "--catalog") {
+			settings.catalogFiles.emplace_back(argv[++i]);
+		} else if (argument == "--engines") {
+			settings.engineNames = Split(argv[++i]);
+		} else if (argument == "--time-limit") {
+			settings.timeLimit = std::chrono::milliseconds(std::max(1, std::atoi(argv[++i])));
+		} else {
+			bValid = false;
+		}
+	}
+
+	std::vector<Engine> engines;
+	for (const Engine& engine : GetEngines()) {
+		const std::vector<std::string>& names = settings.engineNames;
+		if (names.empty() || std::find(names.begin(), names.end(), engine.name) != names.end())
+			engines.push_back(engine);
+	}
+
+	if (!bValid || engines.empty()) {
+		std::cerr
+			<< "Usage: " << argv[0]
+			<< " [--seed <n>] [--puzzles <per shape>] [--repeat <runs per puzzle>] [--grid-sizes <min>-<max>]"
+			<< " [--terminals <min>-<max>] [--holes <density>,...] [--catalog <file>]... [--engines <name>,...]"
+			<< " [--time-limit <ms>] [--check]"
+			<< std::endl;
+		return 1;
+	}
+
+	std::vector<std::pair<std::string, std::shared_ptr<const TCSolver::Catalog>>> catalogs;
+	for (const std::string& catalogFile : settings.catalogFiles) {
+		auto catalog = std::make_shared<TCSolver::Catalog>();
+		catalog->Load(catalogFile);
+		catalogs.emplace_back(std::filesystem::path(catalogFile).stem().string(), std::move(catalog));
+	}
+	if (catalogs.empty()) catalogs.emplace_back("default", TCSolver::Catalog::GetDefault());
+
+	std::cout << std::format(
+		"{:<16} {:<20} {:>4} {:>9} {:>5} {:>5} {:>6} {:>8} {:>12} {:>12} {:>12} {:>10} {:>9}\n",
+		"catalog", "engine", "grid", "terminals", "holes", "runs", "solved", "timeouts",
+		"median_us", "p99_us", "expanded", "peak_kib", "cost"
+	);
+
+	int32_t failureCount = 0;
+	for (const auto& [catalogName, catalog] : catalogs) {
+		for (int32_t gridSize = settings.minGridSize; gridSize <= settings.maxGridSize; ++gridSize) {
+			for (double holeDensity : settings.holeDensities) {
+				// An engine that runs out of time on every puzzle of one size is not tried on larger ones
+				std::vector<uint8_t> bGivenUp(engines.size(), false);
+
+				for (int32_t terminals = settings.minTerminals; terminals <= settings.maxTerminals; ++terminals) {
+					if (terminals > TCSolver::CellIndex::GetCellCount(gridSize)) break;
+
+					std::vector<std::unique_ptr<TCSolver::Config>> puzzles;
+					for (int32_t puzzle = 0; puzzle < settings.puzzleCount; ++puzzle) {
+						// Each shape gets its own stream, so changing one range leaves the other puzzles as they were
+						uint64_t seed = settings.seed;
+						for (int64_t part : {gridSize, terminals, static_cast<int32_t>(holeDensity * 1000), puzzle})
+							seed = TCSolver::Solver::SplitMix64(seed ^ part);
+						puzzles.push_back(TCSolver::Bench::Generate(catalog, {gridSize, terminals, holeDensity, seed}));
+					}
+
+					std::vector<Sample> samples(engines.size());
+					for (size_t engineIndex = 0; engineIndex < engines.size(); ++engineIndex) {
+						const Engine& engine = engines[engineIndex];
+						if (bGivenUp[engineIndex] || terminals < engine.minTerminals || terminals > engine.maxTerminals)
+							continue;
+
+						Sample& sample = samples[engineIndex];
+						for (const std::unique_ptr<TCSolver::Config>& puzzle : puzzles)
+							Measure(engine, *puzzle, settings, sample);
+						bGivenUp[engineIndex] = sample.timeoutCount == sample.puzzleCount;
+
+						std::cout << std::format(
+							"{:<16} {:<20} {:>4} {:>9} {:>5.2f} {:>5} {:>6} {:>8} {:>12.1f} {:>12.1f} {:>12} {:>10} {:>9}\n",
+							catalogName, engine.name, gridSize, terminals, holeDensity, sample.times.size(),
+							sample.solvedCount, sample.timeoutCount, GetPercentile(sample.times, 0.5),
+							GetPercentile(sample.times, 0.99), GetPercentile(sample.expanded, 0.5),
+							sample.peakBytes / 1024, sample.totalCost
+						) << std::flush;
+
+						if (sample.invalidCount > 0) {
+							std::cerr << std::format(
+								"{} returned {} invalid boards on {} grid-{} puzzles with {} terminals and {:.2f} holes\n",
+								engine.name, sample.invalidCount, catalogName, gridSize, terminals, holeDensity
+							);
+						}
+						failureCount += sample.invalidCount;
+					}
+
+					if (!settings.bCheck) continue;
+					for (size_t engineIndex = 0; engineIndex < engines.size(); ++engineIndex) {
+						const Engine& engine = engines[engineIndex];
+						auto reference = std::find_if(engines.begin(), engines.end(), [&](const Engine& other) {
+							return other.name == engine.reference;
+						});
+						if (reference == engines.end()) continue;
+
+						// Engines skipped on this shape have no costs to compare
+						const Sample& sample = samples[engineIndex];
+						const Sample& referenceSample = samples[reference - engines.begin()];
+						if (sample.costs.empty() || referenceSample.costs.empty()) continue;
+
+						int32_t mismatchCount = 0;
+						for (size_t puzzle = 0; puzzle < sample.costs.size(); ++puzzle) {
+							int32_t cost = sample.costs[puzzle];
+							int32_t referenceCost = referenceSample.costs[puzzle];
+							if (cost >= 0 && referenceCost >= 0 && cost != referenceCost) ++mismatchCount;
+						}
+						if (mismatchCount > 0) {
+							std::cerr << std::format(
+								"{} and {} disagree on {} {} grid-{} puzzles with {} terminals and {:.2f} holes\n",
+								engine.name, reference->name, mismatchCount, catalogName, gridSize, terminals,
+								holeDensity
+							);
+						}
+						failureCount += mismatchCount;
+
+						// Only runs that finished count towards the peak
+						if (!engine.bLeaner || sample.times.empty() || referenceSample.times.empty()) continue;
+						if (sample.peakBytes < referenceSample.peakBytes) continue;
+						std::cerr << std::format(
+							"{} peaked at {} KiB, not below {}'s {} KiB, on {} grid-{} puzzles with {} terminals\n",
+							engine.name, sample.peakBytes / 1024, reference->name, referenceSample.peakBytes / 1024,
+							catalogName, gridSize, terminals
+						);
+						++failureCount;
+					}
+				}
+			}
+		}
+	}
+
+	return failureCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "Catalog.hpp"
+#include "Dispatch.hpp"
+#include "ThreadPool.hpp"
+
+namespace TCSolver {
+
+/**
+ * Long-running solver answering puzzle requests, one JSON object per line, over stdin/stdout or a Unix domain socket.
+ *
+ * A request is a puzzle in the same shape as a config file ("grid-size", "terminals", optionally "aspects"), plus:
+ *   "id"          any JSON value, echoed back so answers to concurrent requests can be told apart
+ *   "catalog"     name of a catalog loaded at startup, instead of the default one
+ *   "solver"      one of Solver::SOLVER_NAMES
+ *   "timeout-ms"  time budget counted from when the request was read, or 0 for none
+ *   "stats"       whether the answer carries solver statistics (see Solver::WriteJson)
+ * Requests are solved on a worker pool and each is answered with one line as soon as it is done, so answers may come
+ * back in a different order than the requests.
+ */
+class Daemon {
+public:
+	struct Settings {
+	public:
+		// Catalogs requests can ask for by name. Other requests use defaultCatalog, or the embedded default if null.
+		std::map<std::string, std::shared_ptr<const Catalog>, std::less<>> catalogs;
+		std::shared_ptr<const Catalog> defaultCatalog;
+		std::string_view solverName = "dijkstra-steiner";
+		// Requests solved at once. Each one runs on a single thread.
+		int32_t threadCount = 1;
+		std::chrono::milliseconds timeout = std::chrono::milliseconds::zero();
+		Solver::SolutionCache* cache = nullptr;
+		// Whether answers carry a "stats" member, unless a request says otherwise
+		bool bStats = false;
+		// See Solver::Options
+		bool bBoundedMemory = false;
+		// Whether running out of time answers with the cheapest tree found so far, instead of none
+		bool bAnytime = false;
+	};
+
+	/**
+	 * Also makes YAML and JSON parse errors throw rather than abort, for every parse in the process.
+	 */
+	explicit Daemon(Settings settings);
+	~Daemon() = default;
+
+	Daemon(Daemon&& other) = delete;
+	Daemon& operator=(Daemon&& other) = delete;
+	Daemon(const Daemon&) = delete;
+	Daemon& operator=(const Daemon&) = delete;
+
+	/**
+	 * Answers requests from stdin on stdout until stdin is closed and every answer is written.
+	 */
+	void ServeStream();
+
+	/**
+	 * Listens on a Unix domain socket at path, replacing a stale socket file, and serves every client until the
+	 * process is stopped. Throws if the socket cannot be set up.
+	 */
+	void ServeSocket(const std::string& path);
+
+	/**
+	 * Solves a single request line and returns the answer line, without the trailing newline.
+	 */
+	std::string Handle(std::string_view request, std::chrono::steady_clock::time_point received);
+
+private:
+	Settings settings;
+	std::mutex pendingMutex;
+	std::condition_variable pendingCondition;
+	size_t pendingCount = 0;
+	// Declared last so queued requests are answered before anything they use is destroyed
+	ThreadPool pool;
+
+	/**
+	 * Queues a request on the pool, and passes its answer to reply once it is solved.
+	 */
+	void Submit(std::string request, std::function<void(const std::string&)> reply);
+
+	/**
+	 * Reads requests from a connected client until it hangs up. The socket is closed after the last answer is sent.
+	 */
+	void ServeConnection(int32_t socket);
+};
+
+}
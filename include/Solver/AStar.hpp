@@ -56,24 +56,33 @@ public:
 	constexpr friend bool operator!=(const State& lhs, const State& rhs) noexcept { return !(lhs == rhs); }
 };
 
-bool Solve(const Graph& graph, Hex start, Hex end, std::vector<State>& path);
+/**
+ * A search node in the pool. Nodes refer to their parent by index, and the open set holds only indices.
+ */
+struct PathNode {
+public:
+	uint64_t placementMask;
+	int32_t parent;
+	int16_t aspectId;
+	int8_t cell;
+	int8_t gCost;
+	int8_t hCost;
+	int8_t tier;
+};
 
-}
+bool Solve(const Graph& graph, Hex start, Hex end, std::vector<State>& path, const Solver::Options& options = {});
+
+/**
+ * Same as Solve, but grows one frontier from each end and joins them where they first meet on the same cell and
+ * aspect. Stops once either frontier's lowest f cost passes the cheapest join found (Pohl's condition), so it
+ * expands far fewer states than one-directional search when the ends are far apart.
+ */
+bool SolveBidirectional(
+	const Graph& graph,
+	Hex start,
+	Hex end,
+	std::vector<State>& path,
+	const Solver::Options& options = {}
+);
 
-namespace std {
-template<>
-struct hash<TCSolver::AStar::State> {
-	size_t operator()(const TCSolver::AStar::State& state) const noexcept {
-		uint64_t hash = 0x9E3779B97F4A7C15ULL;
-		hash ^= TCSolver::Solver::SplitMix64(
-			static_cast<uint64_t>(state.aspectId) | static_cast<uint64_t>(state.hCost) << 32
-		);
-		hash ^= TCSolver::Solver::SplitMix64(
-			static_cast<uint64_t>(state.gCost) | static_cast<uint64_t>(state.tier) << 32
-		);
-		hash ^= std::hash<TCSolver::Hex>()(state.position);
-		hash ^= TCSolver::Solver::SplitMix64(state.placementMask);
-		return static_cast<size_t>(hash);
-	}
-};
 }
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace TCSolver::Solver {
+
+/**
+ * Bump allocator for the short-lived containers of a solve, with one instance per thread.
+ *
+ * Allocation moves a cursor through a list of blocks and deallocation does nothing (unless it frees the latest
+ * allocation, which just moves the cursor back), so maps and queues with millions of entries cost no malloc/free
+ * traffic and no teardown. A Scope marks the cursor and moves it back when it ends,
+ * which hands everything allocated in between back at once. The blocks stay with the thread for its next solve. When
+ * the outermost scope ends they are merged into a single block, capped at MAX_RETAINED_BYTES, so a long-running
+ * process keeps neither a trail of small blocks nor the peak of one unusually large solve.
+ *
+ * Not thread-safe. Containers filled on several threads, or outliving the scope they were made in, must not use it.
+ */
+class Arena final : public std::pmr::memory_resource {
+public:
+	static constexpr size_t MIN_BLOCK_BYTES = 64 * 1024;
+	static constexpr size_t MAX_RETAINED_BYTES = 64 * 1024 * 1024;
+
+	/**
+	 * Gives back everything the calling thread's arena hands out between construction and destruction. Containers
+	 * using the arena must be declared after the scope, so they are destroyed before it ends.
+	 */
+	class Scope {
+	public:
+		Scope() noexcept;
+		~Scope();
+
+		Scope(Scope&& other) = delete;
+		Scope& operator=(Scope&& other) = delete;
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		std::pmr::memory_resource* GetResource() const noexcept { return &arena; }
+
+	private:
+		Arena& arena;
+		size_t block;
+		size_t offset;
+	};
+
+	Arena() = default;
+	~Arena() override = default;
+
+	Arena(Arena&& other) = delete;
+	Arena& operator=(Arena&& other) = delete;
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	/**
+	 * The calling thread's arena.
+	 */
+	static Arena& ForThread() noexcept;
+
+	/**
+	 * Bytes held in blocks, whether in use or not.
+	 */
+	size_t GetCapacity() const noexcept;
+
+	/**
+	 * Most bytes in use at once since the last ResetPeakUsage, counting blocks skipped over as in use.
+	 */
+	size_t GetPeakUsage() const noexcept { return peakUsage; }
+	void ResetPeakUsage() noexcept { peakUsage = 0; }
+
+private:
+	struct FreeDeleter {
+	public:
+		void operator()(std::byte* data) const noexcept { std::free(data); }
+	};
+
+	/**
+	 * Blocks come straight from malloc, so heap accounting that hooks operator new can add GetPeakUsage without
+	 * counting the blocks as well.
+	 */
+	struct Block {
+	public:
+		std::unique_ptr<std::byte[], FreeDeleter> data;
+		size_t size;
+		// Bytes held by the blocks before this one
+		size_t start;
+	};
+
+	std::vector<Block> blocks;
+	// The block being bumped through, and the cursor within it
+	size_t current = 0;
+	size_t offset = 0;
+	int32_t scopeDepth = 0;
+	size_t peakUsage = 0;
+
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* memory, size_t bytes, size_t) noexcept override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+	void AddBlock(size_t size);
+	void Rewind(size_t block, size_t blockOffset) noexcept;
+};
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+namespace TCSolver::Solver {
+
+/**
+ * Monotone-ish priority queue for small integer keys (Dial's algorithm).
+ *
+ * Each key gets its own bucket, and a cursor tracks the lowest bucket that may be non-empty. Search costs here are
+ * bounded by the cell count, so the bucket array stays tiny and push and pop are O(1) amortized. Pushing below the
+ * cursor is allowed and just moves it back. Entries with equal keys come out last in, first out.
+ */
+template<typename T>
+class BucketQueue {
+public:
+	BucketQueue() = default;
+	explicit BucketQueue(std::pmr::memory_resource* resource) : buckets(resource) {}
+	~BucketQueue() = default;
+
+	BucketQueue(BucketQueue&& other) noexcept = default;
+	BucketQueue& operator=(BucketQueue&& other) noexcept = default;
+	BucketQueue(const BucketQueue&) = delete;
+	BucketQueue& operator=(const BucketQueue&) = delete;
+
+	/**
+	 * Adds an entry. Keys index the buckets, so they must not be negative.
+	 */
+	void Push(int32_t key, const T& value) {
+		assert(key >= 0);
+		if (key >= static_cast<int32_t>(buckets.size())) buckets.resize(key + 1);
+		buckets[key].push_back(value);
+		minKey = std::min(minKey, key);
+		++count;
+	}
+
+	/**
+	 * Removes and returns an entry with the lowest key. The queue must not be empty.
+	 */
+	T Pop() {
+		while (buckets[minKey].empty()) ++minKey;
+
+		T value = std::move(buckets[minKey].back());
+		buckets[minKey].pop_back();
+		if (--count == 0) minKey = std::numeric_limits<int32_t>::max();
+		return value;
+	}
+
+	/**
+	 * The lowest key in the queue, without removing anything. The queue must not be empty.
+	 */
+	int32_t PeekKey() {
+		while (buckets[minKey].empty()) ++minKey;
+		return minKey;
+	}
+
+	bool empty() const noexcept { return count == 0; }
+	size_t size() const noexcept { return count; }
+
+private:
+	std::pmr::vector<std::pmr::vector<T>> buckets;
+	size_t count = 0;
+	int32_t minKey = std::numeric_limits<int32_t>::max();
+};
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Graph.hpp"
+#include "Solver.hpp"
+
+/**
+ * Label-setting Dijkstra-Steiner solver.
+ *
+ * Works on the product graph of (cell, aspect) vertices: an empty cell holding any aspect costs 1, a terminal cell
+ * holding its own aspect costs 0, and two vertices are adjacent when their cells touch and their aspects are linked.
+ * Labels (vertex, terminal subset) are settled in order of cost plus an admissible lower bound on connecting the
+ * terminals not yet covered, so labels that cannot lead to an optimal tree are never expanded.
+ */
+namespace TCSolver::DijkstraSteiner {
+
+struct Label {
+public:
+	int32_t vertex;
+	uint32_t subset;
+	int32_t cost;
+	// Extensions have a single parent. Merges have two, both at the same vertex.
+	int32_t parent1;
+	int32_t parent2;
+	bool bSettled;
+};
+
+struct QueueEntry {
+public:
+	int32_t priority;
+	int32_t cost;
+	int32_t label;
+
+	// Lowest priority first, and the more complete (costlier) label on ties
+	constexpr friend bool operator<(const QueueEntry& lhs, const QueueEntry& rhs) noexcept {
+		return lhs.priority != rhs.priority ? lhs.priority > rhs.priority : lhs.cost < rhs.cost;
+	}
+};
+
+/**
+ * Distance from a terminal to every vertex, counting the weights of all vertices on the path except the last one.
+ * A tree that reaches a vertex needs at least this much more to also reach the terminal.
+ */
+std::vector<uint8_t> GetDistances(const Graph& graph, int32_t terminalCell);
+
+/**
+ * A cost no tree connecting the terminals can beat, found without searching: the tree has to reach every terminal
+ * from the first one.
+ */
+int32_t GetLowerBound(const Graph& graph);
+
+/**
+ * Finds the cheapest tree connecting every terminal, and appends the aspects it places to placements.
+ *
+ * Returns false if the terminals cannot be connected, if the cheapest tree in the product graph would need two
+ * aspects on the same cell (which the board cannot hold), or if the deadline in options passes first. With lowerBound,
+ * it is set to a cost no tree can beat in any of these cases, from the labels settled so far, since labels are settled
+ * in order of their priority and the cheapest tree's is its cost.
+ */
+bool Solve(
+	const Graph& graph,
+	std::vector<Solver::Placement>& placements,
+	const Solver::Options& options = {},
+	int32_t* lowerBound = nullptr
+);
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.hpp"
+#include "Graph.hpp"
+#include "SolutionCache.hpp"
+#include "Solver.hpp"
+
+namespace TCSolver::Solver {
+
+/**
+ * Exact solvers that can be asked for by name. Two-terminal boards always use A*, and boards with more than
+ * MAX_EXACT_TERMINALS terminals always use the heuristic.
+ */
+inline constexpr std::array<std::string_view, 3> SOLVER_NAMES = {"dijkstra-steiner", "dreyfus-wagner", "heuristic"};
+inline constexpr int32_t MAX_EXACT_TERMINALS = 15;
+
+/**
+ * How a solution was reached.
+ */
+struct Stats {
+public:
+	// The solver that produced the solution, after any fallback
+	std::string solver;
+	// Whether the solution came out of the solution cache, or a session's earlier solve, rather than a solver
+	bool bCached = false;
+	// Whether the solver gave up at the deadline in the options, rather than finding no solution
+	bool bTimedOut = false;
+	// Whether an exact solver was asked for, but the heuristic answered because the exact one found no tree the
+	// board can hold, the puzzle had too many terminals, or its deadline passed first
+	bool bFallback = false;
+	std::chrono::microseconds time = std::chrono::microseconds::zero();
+	// See Counters. Cached solutions and solvers without a phase leave these at zero.
+	uint64_t statesExpanded = 0;
+	uint64_t queuePushes = 0;
+	uint64_t stalePops = 0;
+	uint64_t dpEntriesWritten = 0;
+	uint64_t statesStored = 0;
+	std::chrono::microseconds baseCaseTime = std::chrono::microseconds::zero();
+	std::chrono::microseconds searchTime = std::chrono::microseconds::zero();
+	std::chrono::microseconds combineTime = std::chrono::microseconds::zero();
+	// Peak resident memory of the whole process so far, or zero where the platform does not report it
+	uint64_t peakMemoryKib = 0;
+};
+
+struct Solution {
+public:
+	bool bSolved = false;
+	// Aspects placed, which is all a tree costs
+	int32_t cost = 0;
+	// A cost no tree for the board can beat, equal to cost once the solution is proven optimal. Only worked out in
+	// anytime mode, and -1 otherwise.
+	int32_t lowerBound = -1;
+	// Whether the tree is known to be optimal: from an exact solver or the cache, or meeting the lower bound
+	bool bExact = false;
+	std::vector<Placement> placements;
+	Stats stats;
+};
+
+/**
+ * Adds a config's terminals and holes to an empty graph.
+ */
+void AddNodes(Graph& graph, const Config& config);
+
+/**
+ * Writes a solution as the members of a JSON object, each preceded by a comma, so the caller can open the object with
+ * its own leading member. Aspect names are looked up in catalog. Solutions with a lower bound report it along with
+ * the gap to their cost. With bStats, the full stats follow as a "stats" member.
+ */
+void WriteJson(std::ostream& out, const Solution& solution, const Catalog& catalog, bool bStats = false);
+
+/**
+ * Writes stats as a complete JSON object.
+ */
+void WriteJson(std::ostream& out, const Stats& stats);
+
+/**
+ * Solves a graph with the solver suited to its terminal count, and times it.
+ *
+ * When Dijkstra-Steiner's cheapest tree needs two aspects on one cell, or Dreyfus-Wagner rebuilds no tree the board
+ * can hold, the heuristic's tree is returned instead. It is reported as a heuristic solution, so it is not taken for
+ * an optimal one.
+ *
+ * With a cache, a stored solution for any orientation of the same layout is returned instead, and fresh exact
+ * solutions are stored. Heuristic solutions are not, since they may not be optimal, unless their cost meets the lower
+ * bound.
+ *
+ * In anytime mode, a heuristic tree is found first, and the exact solver then gets until the deadline to beat it.
+ * Whichever is cheaper is returned, with a lower bound from the exact search (or from the terminals' distances when
+ * there are too many terminals to search), so a solution is reported even if the exact solver runs out of time.
+ */
+Solution Solve(
+	const Graph& graph,
+	std::string_view solverName,
+	const Options& options = {},
+	SolutionCache* cache = nullptr
+);
+
+/**
+ * Solves a puzzle, parsed from a file or built in memory, as above. This is the entry point for code embedding the
+ * solver, and it neither prints nor touches the filesystem (except through the cache).
+ */
+Solution Solve(
+	const Config& config,
+	std::string_view solverName = SOLVER_NAMES.front(),
+	const Options& options = {},
+	SolutionCache* cache = nullptr
+);
+
+}
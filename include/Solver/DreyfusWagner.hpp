@@ -1,42 +1,98 @@
 #pragma once
 
-#include <bit>
-#include <queue>
+#include <vector>
 
 #include "Graph.hpp"
 #include "Solver.hpp"
+#include "ThreadPool.hpp"
 
+/**
+ * Dreyfus-Wagner Steiner tree solver.
+ *
+ * Works on the same product graph as Dijkstra-Steiner: (cell, aspect) vertices, where an empty cell holding any aspect
+ * costs 1 and a terminal cell holding its own aspect costs 0, and two vertices are adjacent when their cells touch and
+ * their aspects are linked. A vertex is numbered cell * aspect count + aspect id. dp[D][v] is the cost of the cheapest
+ * tree connecting the terminals in subset D to vertex v, v included.
+ */
 namespace TCSolver::DreyfusWagner {
 
-struct State {
+/**
+ * Dense DP storage: one row per terminal subset (indexed by its compact subset bits) and one narrow cost per vertex.
+ *
+ * Costs are bounded by the number of cells, so a byte is plenty. Anything that would reach INFINITE is treated as
+ * unreachable.
+ *
+ * Beside each cost row sit the argmin back-pointers that produced it: for dp[D][v], the neighboring vertex its tree
+ * grew from, or NONE if it is the trees of E and D - E merged at v, and then the subset E. A table without
+ * back-pointers holds the costs alone, a ninth of the memory.
+ */
+class SubsetTable {
 public:
-	int32_t cost;
-	int32_t aspectId;
-	Hex position;
-	uint64_t placementMask;
+	static constexpr uint8_t INFINITE = 0xFF;
+	static constexpr int32_t NONE = -1;
 
-	constexpr friend bool operator<(const State& lhs, const State& rhs) noexcept { return lhs.cost > rhs.cost; }
-};
+	SubsetTable(size_t rowCount, size_t columnCount, bool bBackPointers = true);
+	~SubsetTable() = default;
 
-bool Solve(const Graph& graph);
+	SubsetTable(SubsetTable&& other) = delete;
+	SubsetTable& operator=(SubsetTable&& other) = delete;
+	SubsetTable(const SubsetTable&) = delete;
+	SubsetTable& operator=(const SubsetTable&) = delete;
 
-void Dijkstra(
-	const Graph& graph,
-	const std::unordered_set<Hex>& initialPositions,
-	std::unordered_map<uint128_t, std::unordered_map<uint128_t, int32_t>>& dp,
-	std::unordered_map<uint128_t, uint128_t>& parents,
-	std::unordered_set<uint128_t>& allNodes
-);
+	uint8_t* Row(size_t row) noexcept { return costs.data() + row * columnCount; }
+	const uint8_t* Row(size_t row) const noexcept { return costs.data() + row * columnCount; }
 
-struct MaskPriority {
-	constexpr bool operator()(const uint64_t& lhs, const uint64_t& rhs) const {
-		// Return lhs if has fewer set bits
-		return std::popcount(lhs) > std::popcount(rhs);
-	}
+	/**
+	 * Back-pointer rows, which only a table with back-pointers has.
+	 */
+	int32_t* PredecessorRow(size_t row) noexcept { return predecessors.data() + row * columnCount; }
+	const int32_t* PredecessorRow(size_t row) const noexcept { return predecessors.data() + row * columnCount; }
+
+	uint32_t* SplitRow(size_t row) noexcept { return splits.data() + row * columnCount; }
+	const uint32_t* SplitRow(size_t row) const noexcept { return splits.data() + row * columnCount; }
+
+	size_t GetColumnCount() const noexcept { return columnCount; }
+	bool HasBackPointers() const noexcept { return bBackPointers; }
+
+private:
+	size_t columnCount;
+	bool bBackPointers;
+	std::vector<uint8_t> costs;
+	std::vector<int32_t> predecessors;
+	std::vector<uint32_t> splits;
 };
 
-typedef std::priority_queue<uint64_t, std::vector<uint64_t>, MaskPriority> TerminalSubsets_t;
+/**
+ * Finds the Steiner tree connecting every terminal, and appends the aspects it places to placements. Returns false if
+ * there is none, if the deadline in options passes first, or if the tree rebuilt from the back-pointers is not one the
+ * board can hold at the cost the DP found (two aspects on one cell, a terminal left out, or a different cost).
+ */
+bool Solve(const Graph& graph, std::vector<Solver::Placement>& placements, const Solver::Options& options = {});
 
-constexpr TerminalSubsets_t GetTerminalSubsets(uint64_t terminalMask) noexcept;
+/**
+ * Lowers every cost in a row of vertices to what it takes to grow one of the row's trees out to that vertex, in order
+ * of cost with a bucket queue. With predecessors, each lowered vertex records the neighbor it was reached from. Stops
+ * early, leaving the row incomplete, if the deadline in options passes.
+ */
+void Propagate(const Graph& graph, uint8_t* row, int32_t* predecessors, const Solver::Options& options);
+
+/**
+ * Every subset of the first terminalCount terminals with exactly size members, in increasing order. Built directly
+ * with Gosper's hack, one cardinality layer at a time.
+ */
+constexpr std::vector<uint64_t> GetTerminalSubsets(int32_t terminalCount, int32_t size) {
+	std::vector<uint64_t> subsets;
+	if (size <= 0 || size > terminalCount) return subsets;
+
+	const uint64_t limit = 1ULL << terminalCount;
+	for (uint64_t subset = (1ULL << size) - 1; subset < limit;) {
+		subsets.push_back(subset);
+		uint64_t lowest = subset & -subset;
+		uint64_t ripple = subset + lowest;
+		subset = (((ripple ^ subset) >> 2) / lowest) | ripple;
+	}
+
+	return subsets;
+}
 
 }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <vector>
+
+#include "CellIndex.hpp"
+#include "Graph.hpp"
+#include "Solver.hpp"
+
+/**
+ * Polynomial-time Steiner tree heuristic, for boards with too many terminals for the exact solvers.
+ *
+ * A tree is grown from one terminal by repeatedly connecting the nearest unconnected terminal with a shortest path
+ * (shortest-path heuristic), then improved by local search: redundant placements are removed, and key paths (chains
+ * of placements between terminals or junctions) are torn out and reconnected whenever that makes the tree cheaper.
+ * Every terminal is tried as the starting point, and the cheapest result wins.
+ */
+namespace TCSolver::Heuristic {
+
+/**
+ * The graph's nodes plus the aspects placed so far.
+ */
+struct Board {
+public:
+	// Aspect on every occupied cell, including the graph's own nodes. -1 for empty cells and holes.
+	std::array<int32_t, CellIndex::COUNT> aspects;
+	// Cells placed by the heuristic, not already in the graph
+	uint64_t placedMask;
+
+	explicit Board(const Graph& graph) noexcept;
+
+	int32_t GetCost() const noexcept { return std::popcount(placedMask); }
+};
+
+/**
+ * Cells connected to cell through touching, linked aspects.
+ */
+uint64_t GetComponent(const Graph& graph, const Board& board, int32_t cell);
+
+/**
+ * Places a cheapest path from any cell in sourceMask to any cell in targetMask, and returns false if none is found.
+ * When the cheapest path needs two aspects on one empty cell, that cell is left out and the search repeated, which
+ * can lose the only path there is, so false does not prove the masks cannot be connected.
+ */
+bool Connect(
+	const Graph& graph,
+	Board& board,
+	uint64_t sourceMask,
+	uint64_t targetMask,
+	const Solver::Options& options = {}
+);
+
+/**
+ * Connects every terminal to rootCell, one nearest terminal at a time. Returns false if Connect finds no path for some
+ * terminal.
+ */
+bool Grow(const Graph& graph, Board& board, int32_t rootCell, const Solver::Options& options = {});
+
+/**
+ * Removes placements that no terminal depends on.
+ */
+void Prune(const Graph& graph, Board& board, int32_t rootCell);
+
+/**
+ * Tears out each key path and reconnects the pieces, keeping the result whenever it is cheaper. Stops with the
+ * cheapest tree so far once the deadline in the options passes.
+ */
+void ExchangeKeyPaths(const Graph& graph, Board& board, int32_t rootCell, const Solver::Options& options = {});
+
+/**
+ * Finds a cheap (not necessarily cheapest) tree connecting every terminal, and appends the aspects it places to
+ * placements. Returns false if no starting terminal leads to a tree, which can also happen on boards that have one.
+ * Once the deadline in options passes, no new starting terminal is tried, unless no run has succeeded yet.
+ */
+bool Solve(const Graph& graph, std::vector<Solver::Placement>& placements, const Solver::Options& options = {});
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Catalog.hpp"
+#include "CellIndex.hpp"
+#include "Config.hpp"
+#include "Dispatch.hpp"
+#include "Graph.hpp"
+#include "SolutionCache.hpp"
+
+namespace TCSolver::Solver {
+
+/**
+ * A puzzle kept between solves, for callers that edit it a cell at a time and re-solve after every edit.
+ *
+ * Edits change the board in place, so nothing is parsed again. Solve then skips the solver whenever an earlier answer
+ * is known to still be optimal:
+ *   - nothing changed since the last solve
+ *   - the only edits were new holes on cells the last exact solution leaves empty, since a hole only takes options
+ *     away and the old tree does not need any of them
+ *   - the board is one solved earlier in the session, in any orientation (undoing an edit, for instance)
+ * Anything else is solved from scratch. A solver's base-case searches read every cell they can reach, and the subset
+ * rows are indexed by the nodes those searches find, so one moved terminal or hole invalidates practically all of them.
+ */
+class Session {
+public:
+	/**
+	 * Takes the puzzle the same way as the in-memory Config constructor. With a cache, the session shares it instead of
+	 * keeping solutions to itself.
+	 */
+	Session(
+		std::shared_ptr<const Catalog> catalog,
+		int32_t gridSize,
+		const std::vector<Node>& terminals,
+		std::string_view solverName = SOLVER_NAMES.front(),
+		const Options& options = {},
+		SolutionCache* cache = nullptr
+	);
+	~Session() = default;
+
+	Session(Session&& other) = delete;
+	Session& operator=(Session&& other) = delete;
+	Session(const Session&) = delete;
+	Session& operator=(const Session&) = delete;
+
+	/**
+	 * Puts a terminal on a cell, replacing whatever was there. Throws if the position is outside the grid.
+	 */
+	void SetTerminal(Hex position, int32_t aspectId);
+
+	/**
+	 * Puts a hole on a cell, replacing whatever was there. Throws if the position is outside the grid.
+	 */
+	void SetHole(Hex position);
+
+	/**
+	 * Empties a cell. Throws if the position is outside the grid.
+	 */
+	void Clear(Hex position);
+
+	/**
+	 * Moves a terminal, or hole, to another cell, replacing whatever was there. Throws if either position is outside
+	 * the grid or from is empty.
+	 */
+	void MoveTerminal(Hex from, Hex to);
+
+	/**
+	 * Options for the following solves, such as a fresh deadline.
+	 */
+	void SetOptions(const Options& newOptions) { options = newOptions; }
+
+	/**
+	 * The solution for the board as it is now. Placements stay valid until the next call.
+	 */
+	const Solution& Solve();
+
+	/**
+	 * The board as of the last Solve, or null before the first one.
+	 */
+	const Graph* GetGraph() const noexcept { return graph.get(); }
+
+private:
+	static constexpr int32_t EMPTY = -2;
+	static constexpr int32_t HOLE = -1;
+
+	std::shared_ptr<const Catalog> catalog;
+	int32_t gridSize;
+	std::string solverName;
+	Options options;
+	SolutionCache* cache;
+	SolutionCache ownCache;
+
+	// What each cell holds: EMPTY, HOLE, or a terminal's aspect id
+	std::array<int32_t, CellIndex::COUNT> cells;
+
+	// The board and solution of the last Solve. The graph refers to the config, so it is declared after it.
+	std::unique_ptr<Config> config;
+	std::unique_ptr<Graph> graph;
+	Solution solution;
+
+	bool bSolvedBefore = false;
+	// Cells made into holes since the last Solve, and whether anything else changed
+	uint64_t addedHoles = 0;
+	bool bOtherEdits = false;
+
+	int32_t GetCell(Hex position) const;
+	void SetCell(int32_t cell, int32_t content);
+};
+
+}
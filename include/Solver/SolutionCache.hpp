@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "CellIndex.hpp"
+#include "Graph.hpp"
+#include "Solver.hpp"
+
+namespace TCSolver::Solver {
+
+/**
+ * Cell permutations for the 12 symmetries of the hex board: 6 rotations, each with and without a reflection.
+ */
+namespace Symmetry {
+
+inline constexpr int32_t COUNT = 12;
+
+using Permutation = std::array<int8_t, CellIndex::COUNT>;
+
+constexpr std::array<Permutation, COUNT> BuildPermutations() noexcept {
+	std::array<Permutation, COUNT> permutations;
+	for (int32_t symmetry = 0; symmetry < COUNT; ++symmetry) {
+		for (int32_t cell = 0; cell < CellIndex::COUNT; ++cell) {
+			Hex position = CellIndex::ToHex(cell);
+			// Reflect across the i axis: (i, j, k) -> (i, k, j)
+			if (symmetry >= 6) position = Hex(position.i, -position.i - position.j);
+			// Rotate by 60 degrees: (i, j, k) -> (-j, -k, -i)
+			for (int32_t rotation = 0; rotation < symmetry % 6; ++rotation)
+				position = Hex(-position.j, position.i + position.j);
+			permutations[symmetry][cell] = static_cast<int8_t>(CellIndex::FromHex(position));
+		}
+	}
+	return permutations;
+}
+
+constexpr std::array<Permutation, COUNT> InvertPermutations(const std::array<Permutation, COUNT>& forward) noexcept {
+	std::array<Permutation, COUNT> inverse;
+	for (int32_t symmetry = 0; symmetry < COUNT; ++symmetry) {
+		for (int32_t cell = 0; cell < CellIndex::COUNT; ++cell)
+			inverse[symmetry][forward[symmetry][cell]] = static_cast<int8_t>(cell);
+	}
+	return inverse;
+}
+
+inline constexpr std::array<Permutation, COUNT> FORWARD = BuildPermutations();
+inline constexpr std::array<Permutation, COUNT> INVERSE = InvertPermutations(FORWARD);
+
+static_assert(FORWARD[0][37] == 37 && FORWARD[6][0] == 0);
+static_assert(FORWARD[3][CellIndex::FromHex(Hex(4, 0))] == CellIndex::FromHex(Hex(-4, 0)));
+
+}
+
+/**
+ * Persistent store of solved puzzles, shared by every orientation of the same layout.
+ *
+ * A puzzle's key is its grid size, catalog hash and occupied cells (terminal aspects and holes), taken under whichever
+ * of the 12 board symmetries gives the smallest encoding. Placements are stored in that canonical orientation and
+ * mapped back on lookup. The file is an append-only log, so entries written before a crash survive it.
+ */
+class SolutionCache {
+public:
+	struct Entry {
+	public:
+		std::string solver;
+		std::vector<Placement> placements;
+	};
+
+	/**
+	 * Loads every entry already in the file, and opens it for appending new ones. Throws if it cannot be written.
+	 */
+	explicit SolutionCache(const std::string& filename);
+
+	/**
+	 * Keeps entries in memory only.
+	 */
+	SolutionCache() = default;
+	~SolutionCache() = default;
+
+	SolutionCache(SolutionCache&& other) = delete;
+	SolutionCache& operator=(SolutionCache&& other) = delete;
+	SolutionCache(const SolutionCache&) = delete;
+	SolutionCache& operator=(const SolutionCache&) = delete;
+
+	/**
+	 * The stored solution for a graph, in the graph's own orientation.
+	 */
+	std::optional<Entry> Find(const Graph& graph);
+
+	void Insert(const Graph& graph, const Entry& entry);
+
+	size_t size();
+
+private:
+	std::mutex mutex;
+	std::ofstream log;
+	// Placements keyed by canonical signature, with positions in the canonical orientation
+	std::unordered_map<std::string, Entry> entries;
+
+	/**
+	 * The canonical signature of a graph, and the symmetry that maps the graph onto it.
+	 */
+	static std::pair<std::string, int32_t> GetSignature(const Graph& graph);
+};
+
+}
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "CellIndex.hpp"
 #include "Graph.hpp"
 
 struct uint128_t {
@@ -17,22 +22,125 @@ public:
 
 namespace TCSolver::Solver {
 
+/**
+ * An aspect a solver places on an empty cell.
+ */
+struct Placement {
+public:
+	Hex position;
+	int32_t aspectId;
+};
+
+/**
+ * Work done by solvers, for benchmarks and statistics.
+ */
+struct Counters {
+public:
+	// Search states expanded, plus dynamic-programming entries evaluated
+	std::atomic<uint64_t> statesExpanded = 0;
+	// Entries put on an open set
+	std::atomic<uint64_t> queuePushes = 0;
+	// Entries taken off an open set after a cheaper entry for the same state, and skipped
+	std::atomic<uint64_t> stalePops = 0;
+	// Dynamic-programming table entries improved
+	std::atomic<uint64_t> dpEntriesWritten = 0;
+	// Distinct states held in lookup tables when the search ended
+	std::atomic<uint64_t> statesStored = 0;
+	// Wall time of each phase: distances from the terminals, the main search (or the subset DP), and putting the
+	// final tree together
+	std::atomic<uint64_t> baseCaseNanoseconds = 0;
+	std::atomic<uint64_t> searchNanoseconds = 0;
+	std::atomic<uint64_t> combineNanoseconds = 0;
+};
+
+/**
+ * Settings shared by every solver.
+ */
+struct Options {
+public:
+	// Worker threads a solver may use, including the calling thread
+	int32_t threadCount = 1;
+	// Point at which a solver gives up and reports no solution
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	// Where solvers add up the work they do, if anywhere
+	Counters* counters = nullptr;
+	// Whether Dreyfus-Wagner keeps only its costs in memory, without back-pointers, at the cost of building the rows
+	// the rebuild walks through a second time
+	bool bBoundedMemory = false;
+	// Whether solving starts from a heuristic tree and keeps the cheapest tree found by the deadline, with a proven
+	// lower bound on the optimum, instead of reporting no solution when the exact solver runs out of time
+	bool bAnytime = false;
+
+	bool HasExpired() const noexcept {
+		return deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline;
+	}
+
+	/**
+	 * Adds to one of the counters. Solvers tally in locals and call this once per phase, not once per state.
+	 */
+	void Count(std::atomic<uint64_t> Counters::*counter, uint64_t count) const noexcept {
+		if (counters) (counters->*counter).fetch_add(count, std::memory_order_relaxed);
+	}
+};
+
+/**
+ * Adds the wall time since construction, or since the last Switch, to a phase counter. Without counters in the options
+ * the clock is never read.
+ */
+class PhaseTimer {
+public:
+	PhaseTimer(const Options& options, std::atomic<uint64_t> Counters::*phase) noexcept
+		: options(options), phase(phase) {
+		if (options.counters) start = std::chrono::steady_clock::now();
+	}
+
+	~PhaseTimer() { Stop(); }
+
+	PhaseTimer(PhaseTimer&&) = delete;
+	PhaseTimer& operator=(PhaseTimer&&) = delete;
+	PhaseTimer(const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+	void Switch(std::atomic<uint64_t> Counters::*nextPhase) noexcept {
+		Stop();
+		phase = nextPhase;
+		if (options.counters) start = std::chrono::steady_clock::now();
+	}
+
+private:
+	void Stop() noexcept {
+		if (!options.counters) return;
+		std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+		options.Count(phase, elapsed.count());
+	}
+
+	const Options& options;
+	std::atomic<uint64_t> Counters::*phase;
+	std::chrono::steady_clock::time_point start;
+};
+
 constexpr uint128_t GetMask(uint64_t position, int32_t aspectId) noexcept {
 	return {position, static_cast<uint64_t>(aspectId)};
 }
 
 constexpr uint128_t GetMask(Hex position, int32_t aspectId) noexcept {
-	return {Graph::HEX_ENCODINGS[position], static_cast<uint64_t>(aspectId)};
+	return {CellIndex::ToMask(position), static_cast<uint64_t>(aspectId)};
 }
 
 constexpr std::pair<Hex, int32_t> GetNodeFromMask(uint128_t mask) noexcept {
-	return {Graph::HEX_DECODINGS.at(mask.high), static_cast<int32_t>(mask.low)};
+	return {CellIndex::ToHex(CellIndex::FromMask(mask.high)), static_cast<int32_t>(mask.low)};
 }
 
 constexpr std::pair<uint64_t, int32_t> SeparateMask(uint128_t mask) noexcept {
 	return {mask.high, static_cast<int32_t>(mask.low)};
 }
 
+/**
+ * Whether placements turn the graph into a board the game accepts: every aspect goes on an empty cell of the grid, no
+ * cell gets two, and every terminal ends up connected to the others through touching, linked aspects.
+ */
+bool IsValidTree(const Graph& graph, const std::vector<Placement>& placements);
+
 inline uint64_t SplitMix64(uint64_t x) noexcept {
 	x += 0x9E3779B97F4A7C15ULL;
 	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "Solver.hpp"
+
+namespace TCSolver::Solver {
+
+/**
+ * Assigns each distinct search state a dense 32-bit id, in the order the states are first seen.
+ *
+ * Open addressing with linear probing over a power-of-two slot array. Slots only hold ids, and the keys live in a
+ * separate id-indexed array, so the table stays small and ids can index plain arrays everywhere else.
+ */
+class StateInterner {
+public:
+	static constexpr int32_t NONE = -1;
+
+	StateInterner() : StateInterner(std::pmr::get_default_resource()) {}
+	explicit StateInterner(std::pmr::memory_resource* resource) : slots(1024, NONE, resource), keys(resource) {}
+	~StateInterner() = default;
+
+	StateInterner(StateInterner&& other) noexcept = default;
+	StateInterner& operator=(StateInterner&& other) noexcept = default;
+	StateInterner(const StateInterner&) = delete;
+	StateInterner& operator=(const StateInterner&) = delete;
+
+	/**
+	 * Returns the id of a state, and whether it was newly assigned.
+	 */
+	std::pair<int32_t, bool> Intern(const uint128_t& key) {
+		if (2 * (keys.size() + 1) > slots.size()) Grow();
+
+		size_t slot = Probe(key);
+		if (slots[slot] != NONE) return {slots[slot], false};
+
+		int32_t id = keys.size();
+		slots[slot] = id;
+		keys.push_back(key);
+		return {id, true};
+	}
+
+	int32_t Find(const uint128_t& key) const noexcept { return slots[Probe(key)]; }
+
+	const uint128_t& GetKey(int32_t id) const noexcept { return keys[id]; }
+
+	int32_t size() const noexcept { return keys.size(); }
+
+private:
+	std::pmr::vector<int32_t> slots;
+	std::pmr::vector<uint128_t> keys;
+
+	size_t Probe(const uint128_t& key) const noexcept {
+		size_t slotMask = slots.size() - 1;
+		size_t slot = std::hash<uint128_t>()(key) & slotMask;
+		while (slots[slot] != NONE && keys[slots[slot]] != key) slot = (slot + 1) & slotMask;
+		return slot;
+	}
+
+	void Grow() {
+		slots.assign(slots.size() * 2, NONE);
+		for (int32_t id = 0; id < static_cast<int32_t>(keys.size()); ++id) slots[Probe(keys[id])] = id;
+	}
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace TCSolver {
+
+/**
+ * Fixed set of worker threads fed from a single task queue.
+ */
+class ThreadPool {
+public:
+	/**
+	 * Starts threadCount - 1 workers. The thread calling ParallelFor does its share of the work, so a pool of one
+	 * thread runs everything inline.
+	 */
+	explicit ThreadPool(int32_t threadCount);
+	~ThreadPool();
+
+	ThreadPool(ThreadPool&& other) = delete;
+	ThreadPool& operator=(ThreadPool&& other) = delete;
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int32_t GetThreadCount() const noexcept { return workers.size() + 1; }
+
+	/**
+	 * Runs task(i) for every i in [0, count) and blocks until all of them are done. Indices are handed out one at a
+	 * time, so uneven tasks still balance. The first exception thrown by a task is rethrown here.
+	 */
+	void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
+	/**
+	 * Queues a task for the workers and returns without waiting for it. A pool without workers runs it inline instead.
+	 * The task must not throw. Tasks still queued when the pool is destroyed are run before it finishes.
+	 */
+	void Submit(std::function<void()> task);
+
+private:
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool bStopping = false;
+	// Declared last so the workers are joined before anything they use is destroyed
+	std::vector<std::jthread> workers;
+
+	void Enqueue(std::function<void()> task);
+	void WorkerLoop();
+};
+
+}
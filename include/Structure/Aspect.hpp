@@ -1,7 +1,7 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <unordered_set>
 
 namespace TCSolver {
 
@@ -21,9 +21,6 @@ public:
 	int32_t GetParent2() const noexcept { return parent2; }
 
 	int32_t GetTier() const noexcept { return tier; }
-	
-	void AddRelated(int32_t other);
-	const std::unordered_set<int32_t>& GetLinks() const noexcept { return related; };
 
 	const std::string& GetName() const noexcept { return name; }
 
@@ -35,7 +32,6 @@ private:
 	int32_t parent1 = -1;
 	int32_t parent2 = -1;
 	int32_t tier = 1;
-	std::unordered_set<int32_t> related;
 	std::string name;
 };
 
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Minimal little-endian-as-the-host binary serialization, for files only ever read back by the same build.
+ */
+namespace TCSolver::Binary {
+
+class Writer {
+public:
+	template<typename T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template<typename T>
+	void WriteArray(const std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		Write<uint64_t>(values.size());
+		buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+	}
+
+	void WriteString(std::string_view text) {
+		Write<uint64_t>(text.size());
+		buffer.append(text);
+	}
+
+	const std::string& GetBuffer() const noexcept { return buffer; }
+
+private:
+	std::string buffer;
+};
+
+/**
+ * Reads from a borrowed buffer. Throws if a read runs past its end.
+ */
+class Reader {
+public:
+	Reader(const std::byte* data, size_t size) noexcept : cursor(data), end(data + size) {}
+
+	template<typename T>
+	T Read() {
+		static_assert(std::is_trivially_copyable_v<T>);
+		Require(sizeof(T));
+		T value;
+		std::memcpy(&value, cursor, sizeof(T));
+		cursor += sizeof(T);
+		return value;
+	}
+
+	template<typename T>
+	void ReadArray(std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		uint64_t count = Read<uint64_t>();
+		if (count > static_cast<uint64_t>(end - cursor) / sizeof(T)) throw std::runtime_error("Truncated binary file");
+		values.resize(count);
+		std::memcpy(values.data(), cursor, count * sizeof(T));
+		cursor += count * sizeof(T);
+	}
+
+	std::string_view ReadString() {
+		uint64_t size = Read<uint64_t>();
+		Require(size);
+		std::string_view text(reinterpret_cast<const char*>(cursor), size);
+		cursor += size;
+		return text;
+	}
+
+private:
+	const std::byte* cursor;
+	const std::byte* end;
+
+	void Require(uint64_t size) const {
+		if (size > static_cast<uint64_t>(end - cursor)) throw std::runtime_error("Truncated binary file");
+	}
+};
+
+/**
+ * A whole file mapped read-only into memory (or read into a buffer where mapping is unavailable).
+ */
+class MappedFile {
+public:
+	/**
+	 * Leaves the file closed if it cannot be opened.
+	 */
+	explicit MappedFile(const std::string& filename);
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) = delete;
+	MappedFile& operator=(MappedFile&& other) = delete;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool IsOpen() const noexcept { return data != nullptr; }
+	const std::byte* GetData() const noexcept { return data; }
+	size_t GetSize() const noexcept { return size; }
+
+private:
+	const std::byte* data = nullptr;
+	size_t size = 0;
+	std::vector<std::byte> fallback;
+};
+
+}
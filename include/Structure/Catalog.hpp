@@ -0,0 +1,103 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Aspect.hpp"
+#include "LinkTable.hpp"
+#include "Yaml.hpp"
+
+namespace TCSolver {
+
+/**
+ * The aspects a puzzle can use, and how they link.
+ *
+ * Usually parsed from the "aspects" map of a puzzle file, but one catalog can also be parsed up front and shared by
+ * every puzzle of a batch. A catalog can be compiled into a binary file holding the aspects and the prebuilt link
+ * table, which loads by memory-mapping instead of parsing YAML and rebuilding the links.
+ */
+class Catalog {
+public:
+	Catalog() = default;
+	~Catalog() = default;
+
+	Catalog(Catalog&& other) noexcept = default;
+	Catalog& operator=(Catalog&& other) noexcept = default;
+	Catalog(const Catalog&) = delete;
+	Catalog& operator=(const Catalog&) = delete;
+
+	const std::vector<Aspect>& GetAspects() const noexcept { return aspects; }
+	const LinkTable& GetLinks() const noexcept { return links; }
+
+	/**
+	 * Fingerprint of the aspects and their parents, so results computed against one catalog are not reused with another.
+	 */
+	uint64_t GetHash() const noexcept { return hash; }
+
+	/**
+	 * Returns -1 if there is no aspect with that name.
+	 */
+	int32_t GetAspectIdByName(const std::string& name) const;
+
+	/**
+	 * The Thaumcraft 4 catalog embedded at build time, used by puzzles that bring no aspects of their own.
+	 */
+	static std::shared_ptr<const Catalog> GetDefault();
+
+	/**
+	 * Loads a binary catalog, or a YAML one. For YAML, a compiled copy at filename + ".bin" is used instead when it
+	 * was compiled from the file as it is now.
+	 */
+	void Load(const std::string& filename);
+
+	/**
+	 * Parses the "aspects" map of a catalog (or puzzle) file.
+	 */
+	void Parse(const std::string& filename);
+	void Parse(const ryml::ConstNodeRef& aspectsYamlNode);
+
+	/**
+	 * Compiles a YAML catalog into a binary one, stamped with the YAML file's size and modification time.
+	 */
+	static void Compile(const std::string& yamlFilename, const std::string& binaryFilename);
+
+	void Print() const;
+
+private:
+	// Generated at build time from the catalog file named by TCSOLVER_DEFAULT_CATALOG
+	static const std::string_view DEFAULT_YAML;
+
+	std::vector<Aspect> aspects;
+	std::unordered_map<std::string, int32_t> aspectNames;
+	LinkTable links;
+	uint64_t hash = 0;
+
+	/**
+	 * Identifies the YAML file a binary catalog was compiled from.
+	 */
+	struct SourceStamp {
+	public:
+		uint64_t size;
+		int64_t modified;
+
+		friend bool operator==(const SourceStamp& lhs, const SourceStamp& rhs) noexcept = default;
+	};
+
+	static SourceStamp GetSourceStamp(const std::string& yamlFilename);
+
+	/**
+	 * Returns false, leaving the catalog untouched, if the file is not a binary catalog or its stamp differs from
+	 * expected (when given).
+	 */
+	bool LoadBinary(const std::string& filename, const SourceStamp* expected = nullptr);
+	void Save(const std::string& filename, const SourceStamp& stamp) const;
+
+	void ParseText(std::string content);
+	void UpdateHash() noexcept;
+	void CreateAspectFromYamlNode(const ryml::ConstNodeRef& node);
+};
+
+}
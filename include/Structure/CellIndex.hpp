@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "Hex.hpp"
+
+/**
+ * Dense, compile-time cell numbering for the research grid.
+ *
+ * Cells are numbered ring by ring outward from the center (and lexicographically by (i, j) within a ring), so a grid of
+ * size n uses exactly the ids [0, GetCellCount(n)). A cell's id is also its bit in a placement mask.
+ */
+namespace TCSolver::CellIndex {
+
+inline constexpr int32_t MAX_GRID_SIZE = 5;
+inline constexpr int32_t COUNT = 3 * MAX_GRID_SIZE * (MAX_GRID_SIZE - 1) + 1;
+inline constexpr int32_t INVALID = -1;
+
+constexpr int32_t GetCellCount(int32_t gridSize) noexcept { return 3 * gridSize * (gridSize - 1) + 1; }
+
+/**
+ * The in-bounds neighbors of a cell, in Hex::DIRECTIONS order.
+ */
+struct Neighbors {
+public:
+	int8_t count = 0;
+	std::array<int8_t, 6> cells = {};
+
+	constexpr const int8_t* begin() const noexcept { return cells.data(); }
+	constexpr const int8_t* end() const noexcept { return cells.data() + count; }
+};
+
+namespace Detail {
+
+inline constexpr int32_t RADIUS = MAX_GRID_SIZE - 1;
+inline constexpr int32_t SPAN = 2 * RADIUS + 1;
+
+constexpr std::array<Hex, COUNT> BuildHexes() noexcept {
+	std::array<Hex, COUNT> hexes;
+	int32_t cell = 0;
+	for (int32_t ring = 0; ring <= RADIUS; ++ring) {
+		for (int32_t i = -ring; i <= ring; ++i) {
+			for (int32_t j = -ring; j <= ring; ++j) {
+				if (Hex::Distance(Hex(i, j), Hex::ZERO) == ring) hexes[cell++] = Hex(i, j);
+			}
+		}
+	}
+	return hexes;
+}
+
+inline constexpr std::array<Hex, COUNT> HEXES = BuildHexes();
+
+constexpr std::array<int8_t, SPAN * SPAN> BuildIndices() noexcept {
+	std::array<int8_t, SPAN * SPAN> indices;
+	indices.fill(INVALID);
+	for (int32_t cell = 0; cell < COUNT; ++cell)
+		indices[(HEXES[cell].i + RADIUS) * SPAN + HEXES[cell].j + RADIUS] = static_cast<int8_t>(cell);
+	return indices;
+}
+
+inline constexpr std::array<int8_t, SPAN * SPAN> INDICES = BuildIndices();
+
+constexpr int32_t Lookup(Hex position) noexcept {
+	if (position.i < -RADIUS || position.i > RADIUS || position.j < -RADIUS || position.j > RADIUS) return INVALID;
+	return INDICES[(position.i + RADIUS) * SPAN + position.j + RADIUS];
+}
+
+using NeighborTable = std::array<std::array<Neighbors, COUNT>, MAX_GRID_SIZE + 1>;
+
+constexpr NeighborTable BuildNeighbors() noexcept {
+	NeighborTable table = {};
+	for (int32_t gridSize = 1; gridSize <= MAX_GRID_SIZE; ++gridSize) {
+		for (int32_t cell = 0; cell < GetCellCount(gridSize); ++cell) {
+			Neighbors& neighbors = table[gridSize][cell];
+			for (const Hex& direction : Hex::DIRECTIONS) {
+				Hex neighbor = HEXES[cell] + direction;
+				if (Hex::Distance(neighbor, Hex::ZERO) >= gridSize) continue;
+				neighbors.cells[neighbors.count++] = static_cast<int8_t>(Lookup(neighbor));
+			}
+		}
+	}
+	return table;
+}
+
+inline constexpr NeighborTable NEIGHBORS = BuildNeighbors();
+
+}
+
+/**
+ * Returns the cell id of a position, or INVALID if it lies outside the largest grid.
+ */
+constexpr int32_t FromHex(Hex position) noexcept { return Detail::Lookup(position); }
+
+constexpr Hex ToHex(int32_t cell) noexcept { return Detail::HEXES[cell]; }
+
+constexpr uint64_t ToMask(int32_t cell) noexcept { return 1ULL << cell; }
+
+/**
+ * Returns the cell id of the lowest set bit of a placement mask.
+ */
+constexpr int32_t FromMask(uint64_t mask) noexcept { return std::countr_zero(mask); }
+
+constexpr uint64_t ToMask(Hex position) noexcept { return ToMask(FromHex(position)); }
+
+/**
+ * Neighbors of a cell that lie inside a grid of the given size. Out-of-bounds neighbors are already filtered out.
+ */
+constexpr const Neighbors& GetNeighbors(int32_t gridSize, int32_t cell) noexcept {
+	return Detail::NEIGHBORS[gridSize][cell];
+}
+
+static_assert(FromHex(Hex::ZERO) == 0);
+static_assert(FromHex(Hex(-1, 0)) == 1 && FromHex(Hex(1, 0)) == 6);
+static_assert(FromHex(Hex(-2, 0)) == 7 && FromHex(Hex(2, 0)) == 18);
+static_assert(FromHex(Hex(-4, 0)) == 37 && FromHex(Hex(4, 0)) == 60);
+static_assert(FromHex(Hex(5, 0)) == INVALID && FromHex(Hex(4, 4)) == INVALID);
+static_assert(GetNeighbors(1, 0).count == 0 && GetNeighbors(2, 0).count == 6 && GetNeighbors(3, 7).count == 3);
+
+}
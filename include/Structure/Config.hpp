@@ -1,18 +1,25 @@
 #pragma once
 
-#include <ryml.hpp>
-#include <ryml_std.hpp>
-#include <unordered_map>
+#include <memory>
 
 #include "Aspect.hpp"
+#include "Catalog.hpp"
+#include "LinkTable.hpp"
 #include "Node.hpp"
-#include "NodeType.hpp"
+#include "Yaml.hpp"
 
 namespace TCSolver {
 
 class Config {
 public:
 	Config() = default;
+
+	/**
+	 * Builds a puzzle in memory rather than parsing one. Terminals with aspect id -1 are holes. A null catalog means the
+	 * embedded default catalog.
+	 */
+	Config(std::shared_ptr<const Catalog> catalog, int32_t gridSize, std::vector<Node> terminals);
+
 	~Config() = default;
 
 	Config(const Config&) = delete;
@@ -20,29 +27,33 @@ public:
 	Config& operator=(const Config&) = delete;
 	Config& operator=(Config&&) = delete;
 
-	const std::vector<Aspect>& GetAspects() const noexcept { return aspects; }
+	const Catalog& GetCatalog() const noexcept { return *catalog; }
+	const std::vector<Aspect>& GetAspects() const noexcept { return catalog->GetAspects(); }
+	const LinkTable& GetLinks() const noexcept { return catalog->GetLinks(); }
 	int32_t GetGridSize() const noexcept { return gridSize; }
-	const std::vector<Node>& GetTerminals() { return terminals; }
+	const std::vector<Node>& GetTerminals() const noexcept { return terminals; }
+
+	/**
+	 * Parses a puzzle file. Its own "aspects" map takes precedence. Without one, the puzzle uses sharedCatalog, or the
+	 * embedded default catalog if none is given.
+	 */
+	void Parse(const std::string& filename, std::shared_ptr<const Catalog> sharedCatalog = nullptr);
 
-	void Parse(const std::string& filename);
+	/**
+	 * Parses a puzzle from an already loaded document, such as a daemon request. Keys the puzzle does not use are
+	 * ignored.
+	 */
+	void Parse(const ryml::ConstNodeRef& root, std::shared_ptr<const Catalog> sharedCatalog = nullptr);
 
 	void Print() const;
 
 private:
 	int32_t gridSize = 0;
-	std::vector<Aspect> aspects;
-	std::unordered_map<std::string, int32_t> aspectNames;
+	std::shared_ptr<const Catalog> catalog;
 	std::vector<Node> terminals;
 
-	int32_t GetAspectIdByName(const std::string& name) const;
-
-	ryml::ConstNodeRef GetYamlNode(const ryml::ConstNodeRef& parent, c4::csubstr key, ryml::NodeType type) const;
-
-	void CreateAspectFromYamlNode(const ryml::ConstNodeRef& node);
 	void CreateGraphNodeFromYamlNode(const ryml::ConstNodeRef& node);
 
-	std::string GetYamlNodeKeyName(const ryml::ConstNodeRef& node) const;
-
 	void PrintYaml(const ryml::ConstNodeRef& node, int32_t indentation = 0, bool bInSequence = false) const;
 };
 
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * Helpers for the JSON result lines written by batch and daemon mode.
+ */
+namespace TCSolver::Json {
+
+/**
+ * Quotes and escapes text as a JSON string.
+ */
+std::string Quote(std::string_view text);
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Aspect.hpp"
+#include "Binary.hpp"
+
+namespace TCSolver {
+
+/**
+ * Flat aspect adjacency, built once after the catalog is parsed.
+ *
+ * Each aspect gets a bitset row for constant-time compatibility tests, and a contiguous, sorted list of linked aspect
+ * ids for iteration. Two aspects are linked if one is a parent of the other.
+ *
+ * Also holds the length of the shortest chain of links between every pair of aspects, which bounds how many steps a
+ * path has to take to turn one aspect into another.
+ */
+class LinkTable {
+public:
+	static constexpr uint8_t UNREACHABLE = 0xFF;
+
+	LinkTable() = default;
+	~LinkTable() = default;
+
+	LinkTable(LinkTable&& other) noexcept = default;
+	LinkTable& operator=(LinkTable&& other) noexcept = default;
+	LinkTable(const LinkTable&) = delete;
+	LinkTable& operator=(const LinkTable&) = delete;
+
+	void Build(const std::vector<Aspect>& aspects);
+
+	/**
+	 * Stores or restores everything Build computes, so a compiled catalog can skip it.
+	 */
+	void Write(Binary::Writer& writer) const;
+	void Read(Binary::Reader& reader);
+
+	int32_t GetAspectCount() const noexcept { return aspectCount; }
+
+	bool IsLinked(int32_t lhs, int32_t rhs) const noexcept
+		{ return (bits[lhs * wordsPerRow + (rhs >> 6)] >> (rhs & 63)) & 1ULL; }
+
+	std::span<const int32_t> GetLinks(int32_t aspectId) const noexcept
+		{ return {ids.data() + offsets[aspectId], ids.data() + offsets[aspectId + 1]}; }
+
+	/**
+	 * Fewest links needed to get from one aspect to another, or UNREACHABLE.
+	 */
+	int32_t GetChainLength(int32_t from, int32_t to) const noexcept { return chainLengths[from * aspectCount + to]; }
+
+private:
+	int32_t aspectCount = 0;
+	int32_t wordsPerRow = 0;
+	std::vector<uint64_t> bits;
+	std::vector<int32_t> offsets;
+	std::vector<int32_t> ids;
+	std::vector<uint8_t> chainLengths;
+};
+
+}
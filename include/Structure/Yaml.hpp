@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ryml.hpp>
+#include <ryml_std.hpp>
+#include <string>
+
+#include "NodeType.hpp"
+
+/**
+ * Shared helpers for reading the YAML config and catalog files.
+ */
+namespace TCSolver::Yaml {
+
+/**
+ * Reads a whole file into memory. Throws if it cannot be opened.
+ */
+std::string ReadFile(const std::string& filename);
+
+/**
+ * The child of parent under key, checked to be of the given type. Throws if it is missing or of another type.
+ */
+ryml::ConstNodeRef GetNode(const ryml::ConstNodeRef& parent, c4::csubstr key, ryml::NodeType type);
+
+/**
+ * A readable name for a node, for error messages.
+ */
+std::string GetKeyName(const ryml::ConstNodeRef& node);
+
+}
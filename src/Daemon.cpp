@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <csignal>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "Config.hpp"
+#include "Daemon.hpp"
+#include "Json.hpp"
+#include "Yaml.hpp"
+
+namespace {
+
+[[noreturn]] void ThrowParseError(const char* message, size_t length, ryml::Location, void*) {
+	throw std::runtime_error(std::format("Could not parse: {}", std::string_view(message, length)));
+}
+
+}
+
+TCSolver::Daemon::Daemon(Settings settings) : settings(std::move(settings)), pool(this->settings.threadCount + 1) {
+	// The default callback aborts, which would take every other client down with one malformed request
+	ryml::set_callbacks(ryml::Callbacks(nullptr, nullptr, nullptr, ThrowParseError));
+}
+
+void TCSolver::Daemon::ServeStream() {
+	std::mutex outputMutex;
+
+	std::string request;
+	while (std::getline(std::cin, request)) {
+		if (request.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+		Submit(std::move(request), [&outputMutex](const std::string& answer) {
+			std::lock_guard lock(outputMutex);
+			std::cout << answer << std::endl;
+		});
+	}
+
+	std::unique_lock lock(pendingMutex);
+	pendingCondition.wait(lock, [this]() { return pendingCount == 0; });
+}
+
+#ifdef _WIN32
+
+void TCSolver::Daemon::ServeSocket(const std::string&) {
+	throw std::runtime_error("Unix domain sockets are not supported on this platform");
+}
+
+void TCSolver::Daemon::ServeConnection(int32_t) {}
+
+#else
+
+void TCSolver::Daemon::ServeSocket(const std::string& path) {
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path))
+		throw std::runtime_error(std::format("Socket path is too long: {}", path));
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	int32_t listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0) throw std::runtime_error(std::format("Could not create socket: {}", std::strerror(errno)));
+
+	::unlink(path.c_str());
+	if (
+		::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0
+		|| ::listen(listener, SOMAXCONN) < 0
+	) {
+		std::string error = std::strerror(errno);
+		::close(listener);
+		throw std::runtime_error(std::format("Could not listen on {}: {}", path, error));
+	}
+
+	// A client hanging up before its answer is written must not stop the daemon
+	std::signal(SIGPIPE, SIG_IGN);
+
+	while (true) {
+		int32_t client = ::accept(listener, nullptr, nullptr);
+		if (client >= 0) {
+			std::thread([this, client]() { ServeConnection(client); }).detach();
+		} else if (errno != EINTR && errno != ECONNABORTED) {
+			std::string error = std::strerror(errno);
+			::close(listener);
+			throw std::runtime_error(std::format("Could not accept a connection on {}: {}", path, error));
+		}
+	}
+}
+
+void TCSolver::Daemon::ServeConnection(int32_t socket) {
+	// Shared with every pending answer, so the socket stays open until the last one is sent
+	struct Connection {
+	public:
+		int32_t socket;
+		std::mutex mutex;
+
+		~Connection() { ::close(socket); }
+	};
+	auto connection = std::make_shared<Connection>(socket);
+
+	auto reply = [connection](const std::string& answer) {
+		std::string line = answer + "\n";
+		std::lock_guard lock(connection->mutex);
+		for (size_t written = 0; written < line.size();) {
+			ssize_t count = ::write(connection->socket, line.data() + written, line.size() - written);
+			if (count < 0 && errno == EINTR) continue;
+			if (count <= 0) return;
+			written += count;
+		}
+	};
+
+	std::string buffer;
+	char chunk[4096];
+	while (true) {
+		ssize_t count = ::read(socket, chunk, sizeof(chunk));
+		if (count < 0 && errno == EINTR) continue;
+		if (count <= 0) break;
+		buffer.append(chunk, count);
+
+		size_t start = 0;
+		for (size_t end; (end = buffer.find('\n', start)) != std::string::npos; start = end + 1) {
+			std::string request = buffer.substr(start, end - start);
+			if (request.find_first_not_of(" \t\r") != std::string::npos) Submit(std::move(request), reply);
+		}
+		buffer.erase(0, start);
+	}
+}
+
+#endif
+
+std::string TCSolver::Daemon::Handle(std::string_view request, std::chrono::steady_clock::time_point received) {
+	std::string id = "null";
+	std::ostringstream body;
+
+	try {
+		std::string content(request);
+		ryml::Tree tree = ryml::parse_json_in_place(ryml::to_substr(content));
+		ryml::ConstNodeRef root = tree.rootref();
+		if (!root.is_map()) throw std::runtime_error("Expected the request to be a JSON object");
+
+		if (root.has_child("id")) {
+			ryml::ConstNodeRef idNode = Yaml::GetNode(root, "id", ryml::NodeType::Value);
+			std::string_view value = idNode.val();
+			id = idNode.is_val_quoted() ? Json::Quote(value) : std::string(value.empty() ? "null" : value);
+		}
+
+		std::shared_ptr<const Catalog> catalog = settings.defaultCatalog;
+		if (root.has_child("catalog")) {
+			std::string name;
+			Yaml::GetNode(root, "catalog", ryml::NodeType::Value) >> name;
+			auto found = settings.catalogs.find(name);
+			if (found == settings.catalogs.end()) throw std::runtime_error(std::format("Unknown catalog \"{}\"", name));
+			catalog = found->second;
+		}
+
+		std::string solverName(settings.solverName);
+		if (root.has_child("solver")) {
+			Yaml::GetNode(root, "solver", ryml::NodeType::Value) >> solverName;
+			auto found = std::find(Solver::SOLVER_NAMES.begin(), Solver::SOLVER_NAMES.end(), solverName);
+			if (found == Solver::SOLVER_NAMES.end())
+				throw std::runtime_error(std::format("Unknown solver \"{}\"", solverName));
+		}
+
+		std::chrono::milliseconds timeout = settings.timeout;
+		if (root.has_child("timeout-ms")) {
+			int32_t milliseconds;
+			Yaml::GetNode(root, "timeout-ms", ryml::NodeType::Value) >> milliseconds;
+			timeout = std::chrono::milliseconds(milliseconds);
+		}
+
+		bool bStats = settings.bStats;
+		if (root.has_child("stats")) Yaml::GetNode(root, "stats", ryml::NodeType::Value) >> bStats;
+
+		Solver::Options options;
+		options.bBoundedMemory = settings.bBoundedMemory;
+		options.bAnytime = settings.bAnytime;
+		if (timeout > std::chrono::milliseconds::zero()) options.deadline = received + timeout;
+
+		// In anytime mode there is always a heuristic tree to answer with, however late
+		if (options.HasExpired() && !options.bAnytime) {
+			// The whole budget went on waiting for a worker. Unsolved results never look up an aspect name.
+			Solver::Solution solution;
+			solution.stats.bTimedOut = true;
+			Solver::WriteJson(body, solution, *Catalog::GetDefault(), bStats);
+		} else {
+			Config config;
+			config.Parse(root, catalog);
+
+			Solver::Solution solution = Solver::Solve(config, solverName, options, settings.cache);
+			Solver::WriteJson(body, solution, config.GetCatalog(), bStats);
+		}
+	} catch (const std::exception& exception) {
+		body.str("");
+		body << ",\"solved\":false,\"error\":" << Json::Quote(exception.what());
+	}
+
+	return "{\"id\":" + id + body.str() + "}";
+}
+
+void TCSolver::Daemon::Submit(std::string request, std::function<void(const std::string&)> reply) {
+	std::chrono::steady_clock::time_point received = std::chrono::steady_clock::now();
+
+	{
+		std::lock_guard lock(pendingMutex);
+		++pendingCount;
+	}
+
+	pool.Submit([this, request = std::move(request), reply = std::move(reply), received]() {
+		reply(Handle(request, received));
+
+		std::lock_guard lock(pendingMutex);
+		if (--pendingCount == 0) pendingCondition.notify_all();
+	});
+}
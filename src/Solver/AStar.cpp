@@ -1,96 +1,325 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
-#include <queue>
 #include <unordered_map>
 
+#include "Arena.hpp"
 #include "AStar.hpp"
+#include "BucketQueue.hpp"
 #include "Solver.hpp"
 
-bool TCSolver::AStar::Solve(const Graph& graph, Hex start, Hex end, std::vector<State>& path) {
-	std::priority_queue<State> openSet;
-	std::unordered_map<uint128_t, int32_t> gCosts;
-	std::unordered_map<State, State> parents;
+bool TCSolver::AStar::Solve(
+	const Graph& graph,
+	Hex start,
+	Hex end,
+	std::vector<State>& path,
+	const Solver::Options& options
+) {
+	static constexpr int32_t NONE = -1;
+
+	Solver::Arena::Scope arena;
+	std::pmr::vector<PathNode> nodes(arena.GetResource());
+	std::pmr::unordered_map<uint128_t, int32_t> gCosts(arena.GetResource());
+	Solver::BucketQueue<int32_t> openSet(arena.GetResource());
 
 	const Config& config = graph.GetConfig();
-	const std::unordered_set<Hex>& terminals = graph.GetTerminals();
 	const std::vector<Aspect>& aspects = config.GetAspects();
+
+	// Lowest f cost first, then lowest tier
+	int32_t tierCount = 1;
+	for (const Aspect& aspect : aspects) tierCount = std::max(tierCount, aspect.GetTier() + 1);
+	const LinkTable& links = config.GetLinks();
 	int32_t gridSize = config.GetGridSize();
 	static constexpr int32_t MAX_INT = std::numeric_limits<int32_t>::max();
 
-	openSet.push({
-		start,
-		graph.At(start).GetAspectId(),
-		Hex::Distance(start, end), // hCost
-		0, // gCost
-		aspects[graph.At(start).GetAspectId()].GetTier(),
-		graph.GetPlacementMask()
-	});
+	// Every step moves one cell and one link, so neither the grid nor the aspect chain can be crossed any faster
+	const int32_t endCell = CellIndex::FromHex(end);
+	const int32_t endAspect = graph.At(end).GetAspectId();
+	auto getHCost = [&](int32_t cell, int32_t aspectId) {
+		return std::max(Hex::Distance(CellIndex::ToHex(cell), end), links.GetChainLength(aspectId, endAspect));
+	};
+
+	auto push = [&](int32_t cell, int32_t aspectId, int32_t gCost, uint64_t placementMask, int32_t parent) {
+		nodes.push_back({
+			placementMask,
+			parent,
+			static_cast<int16_t>(aspectId),
+			static_cast<int8_t>(cell),
+			static_cast<int8_t>(gCost),
+			static_cast<int8_t>(getHCost(cell, aspectId)),
+			static_cast<int8_t>(aspects[aspectId].GetTier())
+		});
+		const PathNode& node = nodes.back();
+		openSet.Push((node.gCost + node.hCost) * tierCount + node.tier, nodes.size() - 1);
+	};
+
+	Solver::PhaseTimer timer(options, &Solver::Counters::searchNanoseconds);
 
+	// Nothing is pushed with an UNREACHABLE chain length, which would not fit the node's h cost or make a sane key
+	const int32_t startCell = CellIndex::FromHex(start);
+	if (links.GetChainLength(graph.GetAspectAt(startCell), endAspect) == LinkTable::UNREACHABLE) return false;
+	push(startCell, graph.GetAspectAt(startCell), 0, graph.GetPlacementMask(), NONE);
+
+	// Every node in the pool was pushed exactly once
+	uint64_t expanded = 0;
+	auto count = [&]() {
+		options.Count(&Solver::Counters::statesExpanded, expanded);
+		options.Count(&Solver::Counters::queuePushes, nodes.size());
+		options.Count(&Solver::Counters::statesStored, gCosts.size());
+	};
 	while (!openSet.empty()) {
-		State currentState = openSet.top();
-		openSet.pop();
+		int32_t current = openSet.Pop();
+		++expanded;
+
+		// Copied, since pushing neighbors may reallocate the pool
+		const PathNode currentNode = nodes[current];
 
-		if (currentState.position == end) {
-			while (currentState.position != start) {
-				path.push_back(currentState);
-				currentState = parents.at(currentState);
+		if (currentNode.cell == endCell) {
+			count();
+			for (int32_t node = current; nodes[node].parent != NONE; node = nodes[node].parent) {
+				const PathNode& pathNode = nodes[node];
+				path.push_back({
+					CellIndex::ToHex(pathNode.cell),
+					pathNode.aspectId,
+					pathNode.hCost,
+					pathNode.gCost,
+					pathNode.tier,
+					pathNode.placementMask
+				});
 			}
 			std::reverse(path.begin(), path.end());
 			return true;
 		}
 
-		for (const Hex& neighbor : currentState.position.GetNeighboringPositions()) {
-			if (Hex::Distance(neighbor, Hex::ZERO) >= gridSize) continue;
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, currentNode.cell)) {
+			uint64_t neighborPositionMask = CellIndex::ToMask(neighborCell);
 
-			if (currentState.placementMask & Graph::HEX_ENCODINGS.at(neighbor)) {
-				if (!terminals.contains(neighbor)) continue; // If we're not looking at a terminal (aka backtracking)
+			if (currentNode.placementMask & neighborPositionMask) {
+				if (!graph.IsTerminal(neighborCell)) continue; // If we're not looking at a terminal (aka backtracking)
 
-				int32_t existingAspect = graph.At(neighbor).GetAspectId();
-				if (!aspects[currentState.aspectId].GetLinks().contains(existingAspect)) continue;
+				int32_t existingAspect = graph.GetAspectAt(neighborCell);
+				if (!links.IsLinked(currentNode.aspectId, existingAspect)) continue;
+				if (links.GetChainLength(existingAspect, endAspect) == LinkTable::UNREACHABLE) continue;
 
-				uint128_t neighborMask = Solver::GetMask(neighbor, existingAspect);
+				uint128_t neighborMask = Solver::GetMask(neighborPositionMask, existingAspect);
 				const auto it = gCosts.find(neighborMask);
 				int32_t neighborGCost = it == gCosts.end() ? MAX_INT : it->second;
 
-				int32_t gCost = currentState.gCost; // Don't add anything -- Using an existing aspect not placed by us
+				int32_t gCost = currentNode.gCost; // Don't add anything -- Using an existing aspect not placed by us
 				if (gCost >= neighborGCost) continue;
 
-				State newState = {
-					neighbor,
-					existingAspect,
-					Hex::Distance(neighbor, end),
-					gCost,
-					aspects[existingAspect].GetTier(),
-					currentState.placementMask | Graph::HEX_ENCODINGS.at(neighbor)
-				};
-
-				openSet.push(newState);
+				push(neighborCell, existingAspect, gCost, currentNode.placementMask | neighborPositionMask, current);
 				gCosts.insert_or_assign(neighborMask, gCost);
-				parents.insert_or_assign(newState, currentState);
 			} else {
-				for (int32_t aspectId : aspects[currentState.aspectId].GetLinks()) {
-					uint128_t neighborMask = Solver::GetMask(neighbor, aspectId);
+				for (int32_t aspectId : links.GetLinks(currentNode.aspectId)) {
+					if (links.GetChainLength(aspectId, endAspect) == LinkTable::UNREACHABLE) continue;
+
+					uint128_t neighborMask = Solver::GetMask(neighborPositionMask, aspectId);
 					const auto it = gCosts.find(neighborMask);
 					int32_t neighborGCost = it == gCosts.end() ? MAX_INT : it->second;
 
-					int32_t gCost = currentState.gCost + 1;
+					int32_t gCost = currentNode.gCost + 1;
 					if (gCost >= neighborGCost) continue;
 
-					State newState = {
-						neighbor,
-						aspectId,
-						Hex::Distance(neighbor, end),
-						gCost,
-						aspects[aspectId].GetTier(),
-						currentState.placementMask | Graph::HEX_ENCODINGS.at(neighbor)
-					};
-
-					openSet.push(newState);
+					push(neighborCell, aspectId, gCost, currentNode.placementMask | neighborPositionMask, current);
 					gCosts.insert_or_assign(neighborMask, gCost);
-					parents.insert_or_assign(newState, currentState);
 				}
 			}
 		}
 	}
 
+	count();
 	return false;
 }
+
+bool TCSolver::AStar::SolveBidirectional(
+	const Graph& graph,
+	Hex start,
+	Hex end,
+	std::vector<State>& path,
+	const Solver::Options& options
+) {
+	static constexpr int32_t NONE = -1;
+	static constexpr int32_t MAX_INT = std::numeric_limits<int32_t>::max();
+
+	const Config& config = graph.GetConfig();
+	const std::vector<Aspect>& aspects = config.GetAspects();
+	const LinkTable& links = config.GetLinks();
+	const int32_t gridSize = config.GetGridSize();
+	const uint64_t placementMask = graph.GetPlacementMask();
+
+	int32_t tierCount = 1;
+	for (const Aspect& aspect : aspects) tierCount = std::max(tierCount, aspect.GetTier() + 1);
+
+	/**
+	 * One search direction. Forward g costs include the node's own cell, backward ones do not, so a forward and a
+	 * backward node on the same vertex add up to exactly the cost of the joined path.
+	 */
+	struct Frontier {
+	public:
+		Hex target;
+		int32_t targetAspect;
+		bool bBackward;
+		std::pmr::vector<PathNode> nodes;
+		std::pmr::unordered_map<uint128_t, int32_t> bestNodes;
+		Solver::BucketQueue<int32_t> openSet;
+
+		explicit Frontier(std::pmr::memory_resource* resource)
+			: target(), targetAspect(-1), bBackward(false), nodes(resource), bestNodes(resource), openSet(resource) {}
+	};
+
+	const int32_t startCell = CellIndex::FromHex(start);
+	const int32_t endCell = CellIndex::FromHex(end);
+	Solver::Arena::Scope arena;
+	std::array<Frontier, 2> frontiers = {Frontier(arena.GetResource()), Frontier(arena.GetResource())};
+	frontiers[0].target = end;
+	frontiers[0].targetAspect = graph.GetAspectAt(endCell);
+	frontiers[0].bBackward = false;
+	frontiers[1].target = start;
+	frontiers[1].targetAspect = graph.GetAspectAt(startCell);
+	frontiers[1].bBackward = true;
+
+	int32_t bestCost = MAX_INT;
+	int32_t bestForward = NONE;
+	int32_t bestBackward = NONE;
+
+	auto push = [&](int32_t direction, int32_t cell, int32_t aspectId, int32_t gCost, uint64_t mask, int32_t parent) {
+		Frontier& frontier = frontiers[direction];
+		uint128_t vertex = Solver::GetMask(CellIndex::ToMask(cell), aspectId);
+
+		const auto it = frontier.bestNodes.find(vertex);
+		if (it != frontier.bestNodes.end() && frontier.nodes[it->second].gCost <= gCost) return;
+
+		// An UNREACHABLE chain length would not fit the node's h cost or make a sane key, and the node is a dead end
+		int32_t chainLength = links.GetChainLength(aspectId, frontier.targetAspect);
+		if (chainLength == LinkTable::UNREACHABLE) return;
+		int32_t hCost = std::max(Hex::Distance(CellIndex::ToHex(cell), frontier.target), chainLength);
+		frontier.nodes.push_back({
+			mask,
+			parent,
+			static_cast<int16_t>(aspectId),
+			static_cast<int8_t>(cell),
+			static_cast<int8_t>(gCost),
+			static_cast<int8_t>(hCost),
+			static_cast<int8_t>(aspects[aspectId].GetTier())
+		});
+		int32_t node = frontier.nodes.size() - 1;
+		frontier.bestNodes.insert_or_assign(vertex, node);
+		frontier.openSet.Push((gCost + hCost) * tierCount + frontier.nodes[node].tier, node);
+
+		// Join with the other direction, as long as the two halves do not place anything on the same cell
+		const Frontier& other = frontiers[1 - direction];
+		const auto otherIt = other.bestNodes.find(vertex);
+		if (otherIt == other.bestNodes.end()) return;
+
+		const PathNode& otherNode = other.nodes[otherIt->second];
+		if (mask & otherNode.placementMask & ~(placementMask | CellIndex::ToMask(cell))) return;
+		if (gCost + otherNode.gCost >= bestCost) return;
+
+		bestCost = gCost + otherNode.gCost;
+		bestForward = direction == 0 ? node : otherIt->second;
+		bestBackward = direction == 0 ? otherIt->second : node;
+	};
+
+	Solver::PhaseTimer timer(options, &Solver::Counters::searchNanoseconds);
+
+	// Neither direction can reach the other's terminal, and the start's h cost would not fit its node
+	if (links.GetChainLength(frontiers[1].targetAspect, frontiers[0].targetAspect) == LinkTable::UNREACHABLE)
+		return false;
+	push(0, startCell, graph.GetAspectAt(startCell), 0, placementMask, NONE);
+	push(1, endCell, graph.GetAspectAt(endCell), 0, placementMask, NONE);
+
+	uint64_t expanded = 0;
+	uint64_t stale = 0;
+	while (!frontiers[0].openSet.empty() && !frontiers[1].openSet.empty()) {
+		// h counts steps, and the last step onto a terminal is free, so f - 1 is the real lower bound
+		if (
+			bestCost < frontiers[0].openSet.PeekKey() / tierCount
+			|| bestCost < frontiers[1].openSet.PeekKey() / tierCount
+		) break;
+
+		// Grow the smaller frontier
+		int32_t direction = frontiers[0].openSet.size() <= frontiers[1].openSet.size() ? 0 : 1;
+		Frontier& frontier = frontiers[direction];
+
+		int32_t current = frontier.openSet.Pop();
+		++expanded;
+		const PathNode currentNode = frontier.nodes[current];
+
+		// Skip nodes that a cheaper one for the same vertex has since replaced
+		uint128_t vertex = Solver::GetMask(CellIndex::ToMask(currentNode.cell), currentNode.aspectId);
+		if (frontier.bestNodes.at(vertex) != current) {
+			++stale;
+			continue;
+		}
+
+		// Forward steps pay for the cell they enter, backward steps for the cell they leave
+		int32_t leavingCost = frontier.bBackward && !(placementMask & CellIndex::ToMask(currentNode.cell)) ? 1 : 0;
+
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, currentNode.cell)) {
+			uint64_t neighborPositionMask = CellIndex::ToMask(neighborCell);
+			uint64_t mask = currentNode.placementMask | neighborPositionMask;
+
+			if (currentNode.placementMask & neighborPositionMask) {
+				if (!graph.IsTerminal(neighborCell)) continue;
+
+				int32_t existingAspect = graph.GetAspectAt(neighborCell);
+				if (!links.IsLinked(currentNode.aspectId, existingAspect)) continue;
+
+				push(direction, neighborCell, existingAspect, currentNode.gCost + leavingCost, mask, current);
+			} else {
+				int32_t enteringCost = frontier.bBackward ? 0 : 1;
+				for (int32_t aspectId : links.GetLinks(currentNode.aspectId)) {
+					if (links.GetChainLength(aspectId, frontier.targetAspect) == LinkTable::UNREACHABLE) continue;
+					push(direction, neighborCell, aspectId, currentNode.gCost + leavingCost + enteringCost, mask, current);
+				}
+			}
+		}
+	}
+
+	options.Count(&Solver::Counters::statesExpanded, expanded - stale);
+	options.Count(&Solver::Counters::stalePops, stale);
+	for (const Frontier& frontier : frontiers) {
+		options.Count(&Solver::Counters::queuePushes, frontier.nodes.size());
+		options.Count(&Solver::Counters::statesStored, frontier.bestNodes.size());
+	}
+	if (bestCost == MAX_INT) return false;
+
+	// The forward half runs from the start (exclusive) to the meeting vertex, the backward half on to the end
+	const std::pmr::vector<PathNode>& forwardNodes = frontiers[0].nodes;
+	const std::pmr::vector<PathNode>& backwardNodes = frontiers[1].nodes;
+
+	for (int32_t node = bestForward; forwardNodes[node].parent != NONE; node = forwardNodes[node].parent) {
+		const PathNode& pathNode = forwardNodes[node];
+		path.push_back({
+			CellIndex::ToHex(pathNode.cell),
+			pathNode.aspectId,
+			pathNode.hCost,
+			pathNode.gCost,
+			pathNode.tier,
+			pathNode.placementMask
+		});
+	}
+	std::reverse(path.begin(), path.end());
+
+	auto getHCost = [&](int32_t cell, int32_t aspectId) {
+		int32_t chainLength = links.GetChainLength(aspectId, frontiers[0].targetAspect);
+		return std::max(Hex::Distance(CellIndex::ToHex(cell), end), chainLength);
+	};
+
+	uint64_t mask = path.empty() ? placementMask : path.back().placementMask;
+	for (int32_t node = backwardNodes[bestBackward].parent; node != NONE; node = backwardNodes[node].parent) {
+		const PathNode& pathNode = backwardNodes[node];
+		mask |= CellIndex::ToMask(pathNode.cell);
+		path.push_back({
+			CellIndex::ToHex(pathNode.cell),
+			pathNode.aspectId,
+			getHCost(pathNode.cell, pathNode.aspectId),
+			bestCost - pathNode.gCost,
+			pathNode.tier,
+			mask
+		});
+	}
+
+	return true;
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <new>
+
+#include "Arena.hpp"
+
+TCSolver::Solver::Arena::Scope::Scope() noexcept : arena(ForThread()), block(arena.current), offset(arena.offset) {
+	++arena.scopeDepth;
+}
+
+TCSolver::Solver::Arena::Scope::~Scope() {
+	--arena.scopeDepth;
+	arena.Rewind(block, offset);
+}
+
+TCSolver::Solver::Arena& TCSolver::Solver::Arena::ForThread() noexcept {
+	static thread_local Arena arena;
+	return arena;
+}
+
+size_t TCSolver::Solver::Arena::GetCapacity() const noexcept {
+	size_t capacity = 0;
+	for (const Block& block : blocks) capacity += block.size;
+	return capacity;
+}
+
+void* TCSolver::Solver::Arena::do_allocate(size_t bytes, size_t alignment) {
+	auto tryBlock = [&](Block& block) -> void* {
+		uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+		size_t start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+		if (start + bytes > block.size) return nullptr;
+		offset = start + bytes;
+		peakUsage = std::max(peakUsage, block.start + offset);
+		return block.data.get() + start;
+	};
+
+	// The current block, then any later ones kept from an earlier solve
+	for (; current < blocks.size(); ++current, offset = 0) {
+		if (void* memory = tryBlock(blocks[current])) return memory;
+	}
+
+	size_t size = std::max({MIN_BLOCK_BYTES, bytes + alignment, blocks.empty() ? 0 : blocks.back().size * 2});
+	AddBlock(size);
+	current = blocks.size() - 1;
+	offset = 0;
+	return tryBlock(blocks.back());
+}
+
+void TCSolver::Solver::Arena::do_deallocate(void* memory, size_t bytes, size_t) noexcept {
+	if (current >= blocks.size()) return;
+	std::byte* top = blocks[current].data.get() + offset;
+	if (static_cast<std::byte*>(memory) + bytes == top) offset -= bytes;
+}
+
+void TCSolver::Solver::Arena::AddBlock(size_t size) {
+	std::byte* data = static_cast<std::byte*>(std::malloc(size));
+	if (!data) throw std::bad_alloc();
+	size_t start = blocks.empty() ? 0 : blocks.back().start + blocks.back().size;
+	blocks.push_back({std::unique_ptr<std::byte[], FreeDeleter>(data), size, start});
+}
+
+void TCSolver::Solver::Arena::Rewind(size_t block, size_t blockOffset) noexcept {
+	current = block;
+	offset = blockOffset;
+	if (scopeDepth > 0) return;
+
+	// Between solves, so nothing is in use and the blocks can be merged into one sized for the next solve
+	size_t capacity = GetCapacity();
+	if (blocks.size() <= 1 && capacity <= MAX_RETAINED_BYTES) return;
+
+	blocks.clear();
+	size_t size = std::min(capacity, MAX_RETAINED_BYTES);
+	// Without the memory to merge into, the next solve just starts from scratch
+	try {
+		AddBlock(size);
+	} catch (const std::bad_alloc&) {}
+	current = 0;
+	offset = 0;
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <queue>
+
+#include "Arena.hpp"
+#include "DijkstraSteiner.hpp"
+#include "StateInterner.hpp"
+
+std::vector<uint8_t> TCSolver::DijkstraSteiner::GetDistances(const Graph& graph, int32_t terminalCell) {
+	static constexpr uint8_t INFINITE = 0xFF;
+
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t aspectCount = links.GetAspectCount();
+	const int32_t gridSize = graph.GetSideLength();
+
+	std::vector<uint8_t> distances(CellIndex::COUNT * aspectCount, INFINITE);
+	std::deque<int32_t> openSet;
+
+	int32_t start = terminalCell * aspectCount + graph.GetAspectAt(terminalCell);
+	distances[start] = 0;
+	openSet.push_back(start);
+
+	// 0-1 BFS. Leaving a vertex costs its own weight, so each distance excludes the weight of the vertex it ends at.
+	while (!openSet.empty()) {
+		int32_t vertex = openSet.front();
+		openSet.pop_front();
+
+		int32_t cell = vertex / aspectCount;
+		int32_t aspectId = vertex % aspectCount;
+		int32_t weight = graph.IsTerminal(cell) ? 0 : 1;
+		int32_t distance = distances[vertex] + weight;
+
+		auto relax = [&](int32_t neighbor) {
+			if (distances[neighbor] <= distance) return;
+			distances[neighbor] = distance;
+			if (weight == 0) openSet.push_front(neighbor);
+			else openSet.push_back(neighbor);
+		};
+
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+			if (graph.GetPlacementMask() & CellIndex::ToMask(neighborCell)) {
+				if (!graph.IsTerminal(neighborCell)) continue;
+
+				int32_t existingAspect = graph.GetAspectAt(neighborCell);
+				if (links.IsLinked(aspectId, existingAspect)) relax(neighborCell * aspectCount + existingAspect);
+			} else {
+				for (int32_t linkedAspect : links.GetLinks(aspectId)) relax(neighborCell * aspectCount + linkedAspect);
+			}
+		}
+	}
+
+	return distances;
+}
+
+int32_t TCSolver::DijkstraSteiner::GetLowerBound(const Graph& graph) {
+	std::vector<int32_t> terminalCells;
+	for (const Hex& terminal : graph.GetTerminals()) terminalCells.push_back(CellIndex::FromHex(terminal));
+	std::sort(terminalCells.begin(), terminalCells.end());
+	if (terminalCells.size() < 2) return 0;
+
+	const int32_t aspectCount = graph.GetConfig().GetLinks().GetAspectCount();
+	const int32_t rootVertex = terminalCells.front() * aspectCount + graph.GetAspectAt(terminalCells.front());
+
+	int32_t bound = 0;
+	for (size_t i = 1; i < terminalCells.size(); ++i)
+		bound = std::max<int32_t>(bound, GetDistances(graph, terminalCells[i])[rootVertex]);
+	return bound;
+}
+
+bool TCSolver::DijkstraSteiner::Solve(
+	const Graph& graph,
+	std::vector<Solver::Placement>& placements,
+	const Solver::Options& options,
+	int32_t* lowerBound
+) {
+	static constexpr int32_t NONE = Solver::StateInterner::NONE;
+	static constexpr int32_t INFINITE = 0xFF;
+
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t aspectCount = links.GetAspectCount();
+	const int32_t gridSize = graph.GetSideLength();
+	const uint64_t placementMask = graph.GetPlacementMask();
+
+	// The first terminal (by cell id) is the root. Bit i of a subset is the i-th of the others.
+	std::vector<int32_t> terminalCells;
+	for (const Hex& terminal : graph.GetTerminals()) terminalCells.push_back(CellIndex::FromHex(terminal));
+	std::sort(terminalCells.begin(), terminalCells.end());
+	if (terminalCells.size() < 2) return !terminalCells.empty();
+
+	const int32_t rootCell = terminalCells.front();
+	terminalCells.erase(terminalCells.begin());
+	const int32_t terminalCount = terminalCells.size();
+	const uint32_t fullSubset = (1U << terminalCount) - 1;
+
+	auto getTerminalVertex = [&](int32_t cell) { return cell * aspectCount + graph.GetAspectAt(cell); };
+	auto getWeight = [&](int32_t vertex) { return graph.IsTerminal(vertex / aspectCount) ? 0 : 1; };
+	const int32_t rootVertex = getTerminalVertex(rootCell);
+
+	Solver::PhaseTimer timer(options, &Solver::Counters::baseCaseNanoseconds);
+
+	std::vector<std::vector<uint8_t>> terminalDistances;
+	for (int32_t cell : terminalCells) terminalDistances.push_back(GetDistances(graph, cell));
+	std::vector<uint8_t> rootDistances = GetDistances(graph, rootCell);
+
+	// Every terminal outside the subset, and the root, still has to be reached from this vertex
+	auto getLowerBound = [&](int32_t vertex, uint32_t subset) {
+		int32_t bound = rootDistances[vertex];
+		for (uint32_t remaining = fullSubset & ~subset; remaining; remaining &= remaining - 1)
+			bound = std::max<int32_t>(bound, terminalDistances[std::countr_zero(remaining)][vertex]);
+		return bound;
+	};
+
+	Solver::Arena::Scope arena;
+	Solver::StateInterner labelIds(arena.GetResource());
+	std::pmr::vector<Label> labels(arena.GetResource());
+	std::pmr::vector<std::pmr::vector<int32_t>> settledAt(CellIndex::COUNT * aspectCount, arena.GetResource());
+	std::priority_queue<QueueEntry, std::pmr::vector<QueueEntry>> openSet(
+		std::less<QueueEntry>(),
+		std::pmr::vector<QueueEntry>(arena.GetResource())
+	);
+	uint64_t pushes = 0;
+
+	auto relax = [&](int32_t vertex, uint32_t subset, int32_t cost, int32_t parent1, int32_t parent2) {
+		auto [label, bNew] = labelIds.Intern({subset, static_cast<uint64_t>(vertex)});
+		if (bNew) labels.push_back({vertex, subset, INFINITE, NONE, NONE, false});
+		if (labels[label].bSettled || cost >= labels[label].cost) return;
+
+		int32_t lowerBound = getLowerBound(vertex, subset);
+		if (lowerBound == INFINITE) return;
+
+		labels[label].cost = cost;
+		labels[label].parent1 = parent1;
+		labels[label].parent2 = parent2;
+		openSet.push({cost + lowerBound, cost, label});
+		++pushes;
+	};
+
+	timer.Switch(&Solver::Counters::searchNanoseconds);
+
+	for (int32_t i = 0; i < terminalCount; ++i) relax(getTerminalVertex(terminalCells[i]), 1U << i, 0, NONE, NONE);
+
+	int32_t target = NONE;
+	int32_t settledPriority = 0;
+	uint64_t popped = 0;
+	uint64_t stale = 0;
+	while (!openSet.empty()) {
+		// Reading the clock on every pop would cost more than the pop itself
+		if (++popped % 1024 == 0 && options.HasExpired()) break;
+
+		QueueEntry entry = openSet.top();
+		openSet.pop();
+
+		if (labels[entry.label].bSettled || entry.cost != labels[entry.label].cost) {
+			++stale;
+			continue;
+		}
+		labels[entry.label].bSettled = true;
+		settledPriority = entry.priority;
+
+		const int32_t vertex = labels[entry.label].vertex;
+		const uint32_t subset = labels[entry.label].subset;
+		const int32_t cost = entry.cost;
+
+		if (vertex == rootVertex && subset == fullSubset) {
+			target = entry.label;
+			break;
+		}
+
+		// Extend the tree by one neighboring vertex
+		int32_t cell = vertex / aspectCount;
+		int32_t aspectId = vertex % aspectCount;
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+			if (placementMask & CellIndex::ToMask(neighborCell)) {
+				if (!graph.IsTerminal(neighborCell)) continue;
+
+				int32_t existingAspect = graph.GetAspectAt(neighborCell);
+				if (!links.IsLinked(aspectId, existingAspect)) continue;
+
+				relax(neighborCell * aspectCount + existingAspect, subset, cost, entry.label, NONE);
+			} else {
+				for (int32_t linkedAspect : links.GetLinks(aspectId))
+					relax(neighborCell * aspectCount + linkedAspect, subset, cost + 1, entry.label, NONE);
+			}
+		}
+
+		// Merge with every settled tree at the same vertex covering disjoint terminals. The shared vertex is only
+		// paid for once.
+		for (int32_t other : settledAt[vertex]) {
+			if (labels[other].subset & subset) continue;
+			relax(vertex, subset | labels[other].subset, cost + labels[other].cost - getWeight(vertex), entry.label, other);
+		}
+		settledAt[vertex].push_back(entry.label);
+	}
+
+	options.Count(&Solver::Counters::statesExpanded, popped - stale);
+	options.Count(&Solver::Counters::stalePops, stale);
+	options.Count(&Solver::Counters::queuePushes, pushes);
+	options.Count(&Solver::Counters::statesStored, labelIds.size());
+	if (lowerBound) *lowerBound = settledPriority;
+	if (target == NONE) return false;
+
+	timer.Switch(&Solver::Counters::combineNanoseconds);
+
+	// Walk the labels back down to the terminals, collecting the vertex each extension added
+	std::vector<int32_t> cellAspects(CellIndex::COUNT, -1);
+	std::vector<int32_t> pending = {target};
+	while (!pending.empty()) {
+		const Label& label = labels[pending.back()];
+		pending.pop_back();
+
+		if (label.parent2 != NONE) {
+			pending.push_back(label.parent1);
+			pending.push_back(label.parent2);
+			continue;
+		}
+		if (label.parent1 == NONE) continue;
+		pending.push_back(label.parent1);
+
+		int32_t cell = label.vertex / aspectCount;
+		int32_t aspectId = label.vertex % aspectCount;
+		if (placementMask & CellIndex::ToMask(cell)) continue;
+		if (cellAspects[cell] != -1 && cellAspects[cell] != aspectId) return false;
+		cellAspects[cell] = aspectId;
+	}
+
+	for (int32_t cell = 0; cell < CellIndex::COUNT; ++cell) {
+		if (cellAspects[cell] != -1) placements.push_back({CellIndex::ToHex(cell), cellAspects[cell]});
+	}
+
+	return true;
+}
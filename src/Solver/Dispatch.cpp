@@ -0,0 +1,222 @@
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "AStar.hpp"
+#include "DijkstraSteiner.hpp"
+#include "Dispatch.hpp"
+#include "DreyfusWagner.hpp"
+#include "Heuristic.hpp"
+#include "Json.hpp"
+
+void TCSolver::Solver::AddNodes(Graph& graph, const Config& config) {
+	for (const TCSolver::Node& terminal : config.GetTerminals()) {
+		graph.Add(terminal.GetPosition(), terminal.GetAspectId());
+		if (terminal.GetAspectId() == -1) continue;
+		graph.AddTerminals({terminal.GetPosition()});
+	}
+}
+
+void TCSolver::Solver::WriteJson(std::ostream& out, const Solution& solution, const Catalog& catalog, bool bStats) {
+	out
+		<< ",\"solved\":" << (solution.bSolved ? "true" : "false")
+		<< ",\"solver\":" << Json::Quote(solution.stats.solver)
+		<< ",\"cached\":" << (solution.stats.bCached ? "true" : "false")
+		<< ",\"timed_out\":" << (solution.stats.bTimedOut ? "true" : "false")
+		<< ",\"fallback\":" << (solution.stats.bFallback ? "true" : "false")
+		<< ",\"time_us\":" << solution.stats.time.count();
+
+	if (bStats) {
+		out << ",\"stats\":";
+		WriteJson(out, solution.stats);
+	}
+
+	if (!solution.bSolved) return;
+
+	out << ",\"cost\":" << solution.cost;
+	if (solution.lowerBound >= 0)
+		out << ",\"lower_bound\":" << solution.lowerBound << ",\"gap\":" << solution.cost - solution.lowerBound;
+
+	out << ",\"placements\":[";
+	for (size_t i = 0; i < solution.placements.size(); ++i) {
+		const Placement& placement = solution.placements[i];
+		out
+			<< (i > 0 ? "," : "")
+			<< "{\"position\":[" << placement.position.i << "," << placement.position.j << "]"
+			<< ",\"aspect\":" << Json::Quote(catalog.GetAspects()[placement.aspectId].GetName()) << "}";
+	}
+	out << "]";
+}
+
+void TCSolver::Solver::WriteJson(std::ostream& out, const Stats& stats) {
+	out
+		<< "{\"solver\":" << Json::Quote(stats.solver)
+		<< ",\"cached\":" << (stats.bCached ? "true" : "false")
+		<< ",\"timed_out\":" << (stats.bTimedOut ? "true" : "false")
+		<< ",\"fallback\":" << (stats.bFallback ? "true" : "false")
+		<< ",\"time_us\":" << stats.time.count()
+		<< ",\"base_case_us\":" << stats.baseCaseTime.count()
+		<< ",\"search_us\":" << stats.searchTime.count()
+		<< ",\"combine_us\":" << stats.combineTime.count()
+		<< ",\"states_expanded\":" << stats.statesExpanded
+		<< ",\"queue_pushes\":" << stats.queuePushes
+		<< ",\"stale_pops\":" << stats.stalePops
+		<< ",\"dp_entries_written\":" << stats.dpEntriesWritten
+		<< ",\"states_stored\":" << stats.statesStored
+		<< ",\"peak_memory_kib\":" << stats.peakMemoryKib
+		<< "}";
+}
+
+TCSolver::Solver::Solution TCSolver::Solver::Solve(
+	const Graph& graph,
+	std::string_view solverName,
+	const Options& options,
+	SolutionCache* cache
+) {
+	Solution solution;
+	int32_t terminals = graph.GetTerminals().size();
+
+	Counters counters;
+	Options solverOptions = options;
+	solverOptions.counters = &counters;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::optional<SolutionCache::Entry> cached = cache && terminals > 1 ? cache->Find(graph) : std::nullopt;
+
+	if (cached) {
+		solution.stats.solver = std::move(cached->solver);
+		solution.stats.bCached = true;
+		solution.bSolved = true;
+		solution.placements = std::move(cached->placements);
+	} else if (terminals == 1) {
+		// TODO: explore just the neighbors and choose the cheapest
+		solution.stats.solver = "none";
+		solution.bSolved = true;
+	} else if (terminals == 2) {
+		std::vector<AStar::State> path;
+		solution.stats.solver = "astar";
+		solution.bSolved = AStar::SolveBidirectional(
+			graph,
+			*graph.GetTerminals().cbegin(),
+			*(++graph.GetTerminals().cbegin()),
+			path,
+			solverOptions
+		);
+
+		for (const AStar::State& state : path) {
+			if (!graph.IsTerminal(state.position)) solution.placements.push_back({state.position, state.aspectId});
+		}
+	} else if (terminals > 2) {
+		// Beyond MAX_EXACT_TERMINALS terminals the exact solvers run out of time and memory
+		solution.stats.solver = terminals > MAX_EXACT_TERMINALS ? "heuristic" : solverName;
+
+		// In anytime mode, a heuristic tree to fall back on when the exact solver runs out of time
+		std::vector<Placement> fallback;
+		bool bFallback = false;
+		bool bHeuristicTried = false;
+		if (options.bAnytime) {
+			solution.lowerBound = DijkstraSteiner::GetLowerBound(graph);
+			if (solution.stats.solver != "heuristic") {
+				bFallback = Heuristic::Solve(graph, fallback, solverOptions);
+				bHeuristicTried = true;
+			}
+		}
+
+		if (solution.stats.solver == "dijkstra-steiner") {
+			int32_t lowerBound = 0;
+			solution.bSolved = DijkstraSteiner::Solve(graph, solution.placements, solverOptions, &lowerBound);
+			if (options.bAnytime) solution.lowerBound = std::max(solution.lowerBound, lowerBound);
+
+			// The cheapest tree may need two aspects on one cell, which the board cannot hold. Dreyfus-Wagner searches
+			// the same product graph and would run into the same conflict, so the heuristic's tree is returned
+			// instead, as a solution that is not exact.
+			if (!solution.bSolved && !solverOptions.HasExpired()) solution.stats.solver = "heuristic";
+		}
+
+		if (solution.stats.solver == "dreyfus-wagner") {
+			solution.placements.clear();
+			solution.bSolved = DreyfusWagner::Solve(graph, solution.placements, solverOptions);
+
+			// No tree the board can hold, so settle for the heuristic's, which is not exact
+			if (!solution.bSolved && !solverOptions.HasExpired()) solution.stats.solver = "heuristic";
+		}
+
+		if (solution.stats.solver == "heuristic" && !bHeuristicTried) {
+			solution.placements.clear();
+			solution.bSolved = Heuristic::Solve(graph, solution.placements, solverOptions);
+		}
+
+		if (bFallback && (!solution.bSolved || fallback.size() < solution.placements.size())) {
+			solution.stats.solver = "heuristic";
+			solution.bSolved = true;
+			solution.placements = std::move(fallback);
+		}
+	}
+
+	solution.cost = solution.placements.size();
+	solution.stats.bTimedOut = !solution.bSolved && options.HasExpired();
+	solution.stats.bFallback = !solution.stats.bCached && terminals > 2 && solverName != "heuristic"
+		&& solution.stats.solver == "heuristic";
+
+	// A tree meeting the lower bound is optimal whichever solver found it
+	solution.bExact = solution.bSolved
+		&& (solution.stats.bCached || solution.cost == solution.lowerBound || solution.stats.solver != "heuristic");
+	if (options.bAnytime && solution.bExact) solution.lowerBound = solution.cost;
+	if (cache && !solution.stats.bCached && terminals > 1 && solution.bExact)
+		cache->Insert(graph, {solution.stats.solver, solution.placements});
+
+	auto end = std::chrono::high_resolution_clock::now();
+	solution.stats.time = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+	// Callers with their own counters see this solve's work added to them
+	static constexpr std::array<std::atomic<uint64_t> Counters::*, 8> COUNTERS = {
+		&Counters::statesExpanded,
+		&Counters::queuePushes,
+		&Counters::stalePops,
+		&Counters::dpEntriesWritten,
+		&Counters::statesStored,
+		&Counters::baseCaseNanoseconds,
+		&Counters::searchNanoseconds,
+		&Counters::combineNanoseconds
+	};
+	for (std::atomic<uint64_t> Counters::*counter : COUNTERS) options.Count(counter, counters.*counter);
+
+	auto toMicroseconds = [](uint64_t nanoseconds) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(nanoseconds));
+	};
+	solution.stats.statesExpanded = counters.statesExpanded;
+	solution.stats.queuePushes = counters.queuePushes;
+	solution.stats.stalePops = counters.stalePops;
+	solution.stats.dpEntriesWritten = counters.dpEntriesWritten;
+	solution.stats.statesStored = counters.statesStored;
+	solution.stats.baseCaseTime = toMicroseconds(counters.baseCaseNanoseconds);
+	solution.stats.searchTime = toMicroseconds(counters.searchNanoseconds);
+	solution.stats.combineTime = toMicroseconds(counters.combineNanoseconds);
+
+#ifndef _WIN32
+	rusage usage{};
+	if (::getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		solution.stats.peakMemoryKib = usage.ru_maxrss / 1024;
+#else
+		solution.stats.peakMemoryKib = usage.ru_maxrss;
+#endif
+	}
+#endif
+
+	return solution;
+}
+
+TCSolver::Solver::Solution TCSolver::Solver::Solve(
+	const Config& config,
+	std::string_view solverName,
+	const Options& options,
+	SolutionCache* cache
+) {
+	Graph graph(config);
+	AddNodes(graph, config);
+	return Solve(graph, solverName, options, cache);
+}
@@ -1,302 +1,258 @@
-#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
 
+#include "Arena.hpp"
+#include "BucketQueue.hpp"
 #include "DreyfusWagner.hpp"
 #include "Solver.hpp"
 
-bool TCSolver::DreyfusWagner::Solve(const Graph& graph) {
-	static constexpr int32_t MAX_INT = std::numeric_limits<int32_t>::max();
-
-	// Remove the first terminal to later use as the root for the final part of the algorithm
-	std::unordered_set<Hex> terminals = graph.GetTerminals();
-	Hex rootTerminal = *terminals.begin();
-	terminals.erase(terminals.begin());
+bool TCSolver::DreyfusWagner::Solve(
+	const Graph& graph,
+	std::vector<Solver::Placement>& placements,
+	const Solver::Options& options
+) {
+	static constexpr int32_t NONE = SubsetTable::NONE;
+	static constexpr int32_t INFINITE = SubsetTable::INFINITE;
+
+	const int32_t aspectCount = graph.GetConfig().GetLinks().GetAspectCount();
+	const size_t vertexCount = static_cast<size_t>(CellIndex::GetCellCount(graph.GetSideLength())) * aspectCount;
+
+	// The first terminal (by cell id) is the root. Bit i of a subset is the i-th of the others.
+	std::vector<int32_t> terminalCells;
+	for (const Hex& terminal : graph.GetTerminals()) terminalCells.push_back(CellIndex::FromHex(terminal));
+	std::sort(terminalCells.begin(), terminalCells.end());
+	if (terminalCells.size() < 2) return !terminalCells.empty();
+
+	const int32_t rootCell = terminalCells.front();
+	terminalCells.erase(terminalCells.begin());
+	const int32_t terminalCount = terminalCells.size();
+	const uint64_t fullSubset = (1ULL << terminalCount) - 1;
+
+	auto getTerminalVertex = [&](int32_t cell) { return cell * aspectCount + graph.GetAspectAt(cell); };
+
+	// What each vertex costs: nothing on a terminal's own cell, one placement anywhere else
+	std::vector<uint8_t> weights(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+		weights[vertex] = graph.IsTerminal(vertex / aspectCount) ? 0 : 1;
+
+	ThreadPool pool(options.threadCount);
+	Solver::PhaseTimer timer(options, &Solver::Counters::baseCaseNanoseconds);
+
+	SubsetTable table(fullSubset + 1, vertexCount, !options.bBoundedMemory);
+	const bool bBackPointers = table.HasBackPointers();
+	options.Count(&Solver::Counters::statesStored, vertexCount);
+
+	// Fills D's row: a single terminal's tree is the terminal itself, anything larger starts as the trees of E and
+	// D - E merged at each vertex, paying for the shared vertex once. Either way the trees then grow through the graph.
+	// Back-pointers are written where predecessors and splits are given.
+	auto buildRow = [&](uint64_t subsetD, uint8_t* row, int32_t* predecessors, uint32_t* splits) {
+		if (std::has_single_bit(subsetD)) {
+			row[getTerminalVertex(terminalCells[std::countr_zero(subsetD)])] = 0;
+		} else {
+			// Every split of D once: E keeps D's lowest terminal, and D - E is any non-empty part of the rest. The
+			// minimum of dp[E][v] + dp[D-E][v] covers every tree whose branches at v divide D between them.
+			const uint64_t lowestTerminal = subsetD & -subsetD;
+			const uint64_t rest = subsetD ^ lowestTerminal;
+			uint64_t written = 0;
+			for (uint64_t subsetDMinusE = rest; subsetDMinusE; subsetDMinusE = (subsetDMinusE - 1) & rest) {
+				const uint64_t subsetE = subsetD ^ subsetDMinusE;
+				const uint8_t* rowE = table.Row(subsetE);
+				const uint8_t* rowDMinusE = table.Row(subsetDMinusE);
+
+				for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+					if (rowDMinusE[vertex] == INFINITE || rowE[vertex] == INFINITE) continue;
+					int32_t candidate = rowDMinusE[vertex] + rowE[vertex] - weights[vertex];
+					if (candidate >= row[vertex]) continue;
+
+					row[vertex] = candidate;
+					if (splits) splits[vertex] = subsetE;
+					++written;
+				}
+			}
+			options.Count(&Solver::Counters::dpEntriesWritten, written);
+		}
 
-	// map[fromTerminalSetOrNodeMask, toNode] = distance
-	std::unordered_map<uint128_t, std::unordered_map<uint128_t, int32_t>> dp;
-	dp.reserve(std::max<size_t>(4, terminals.size() * 2));
+		Propagate(graph, row, predecessors, options);
+	};
 
-	std::unordered_set<uint128_t> allNodesSet;
-	allNodesSet.reserve(200000); // Heuristic from testing
+	// 1. (Base case) Each terminal's row holds the cost of reaching every vertex from it
 
-	// parents map used by Dijkstra as before
-	std::unordered_map<uint128_t, uint128_t> parents;
-	parents.reserve(262144); // Heuristic from testing
+	pool.ParallelFor(terminalCount, [&](size_t i) {
+		uint64_t subset = 1ULL << i;
+		int32_t* predecessors = bBackPointers ? table.PredecessorRow(subset) : nullptr;
+		buildRow(subset, table.Row(subset), predecessors, nullptr);
+	});
+	if (options.HasExpired()) return false;
 
-	// 1. (Base case) Find the distance from each terminal to every other reachable node
+	timer.Switch(&Solver::Counters::searchNanoseconds);
 
-	Dijkstra(graph, graph.GetTerminals(), dp, parents, allNodesSet);
+	// 2. For each layer of subsets, smallest first, up to the full set. A subset only reads rows from smaller layers
+	// and writes its own row, so every subset in a layer can run at once.
+	for (int32_t layer = 2; layer <= terminalCount; ++layer) {
+		if (options.HasExpired()) return false;
 
-	// Convert allNodesSet to a vector for much faster iteration
-	std::vector<uint128_t> allNodes(allNodesSet.begin(), allNodesSet.end());
+		std::vector<uint64_t> subsets = GetTerminalSubsets(terminalCount, layer);
 
-	// 2. Iterate over all combinatorial subsets of the terminals that are not empty and not equal to the full set
+		pool.ParallelFor(subsets.size(), [&](size_t subsetIndex) {
+			// Later subsets are skipped once the deadline passes, and the layer check above gives up
+			if (options.HasExpired()) return;
 
-	uint64_t fullTerminalMask = 0;
-	for (const Hex& terminal : terminals) {
-		fullTerminalMask |= Graph::HEX_ENCODINGS[terminal];
+			uint64_t subsetD = subsets[subsetIndex];
+			buildRow(
+				subsetD,
+				table.Row(subsetD),
+				bBackPointers ? table.PredecessorRow(subsetD) : nullptr,
+				bBackPointers ? table.SplitRow(subsetD) : nullptr
+			);
+		});
 	}
 
-	TerminalSubsets_t terminalSubsets = GetTerminalSubsets(fullTerminalMask);
-
-	// 3. For each subset...
-	while (!terminalSubsets.empty()) {
-		uint64_t subsetD = terminalSubsets.top();
-		terminalSubsets.pop();
-
-		// Break down the mask into an iterable list of terminal positions
-		std::vector<uint64_t> terminalPositions;
-		for (int32_t i = 0; i < 64; ++i) {
-			if (subsetD & (1ULL << i)) terminalPositions.push_back(1ULL << i);
+	if (options.HasExpired()) return false;
+	timer.Switch(&Solver::Counters::combineNanoseconds);
+
+	// 3. The tree connecting every terminal to the root
+	const int32_t rootVertex = getTerminalVertex(rootCell);
+	const int32_t steinerDistance = table.Row(fullSubset)[rootVertex];
+	if (steinerDistance == INFINITE) return false;
+
+	// 4. Rebuild the tree by following the back-pointers. A subset's tree at vertex v is either its tree at the
+	// predecessor plus v, or the trees of E and D - E merged at v. The cheapest tree in the product graph can still
+	// hold two aspects on one cell, which the board cannot.
+	struct BackPointers {
+	public:
+		std::vector<uint8_t> costs;
+		std::vector<int32_t> predecessors;
+		std::vector<uint32_t> splits;
+	};
+
+	// Without back-pointers in the table, each row the rebuild walks through is built again, this time with them.
+	// The smaller rows it reads are all still there, so it makes the same choices the table would have recorded.
+	std::unordered_map<uint64_t, BackPointers> rebuiltRows;
+	auto getBackPointers = [&](uint64_t subset) -> std::pair<const int32_t*, const uint32_t*> {
+		if (bBackPointers) return {table.PredecessorRow(subset), table.SplitRow(subset)};
+
+		auto [it, bNew] = rebuiltRows.try_emplace(subset);
+		BackPointers& rows = it->second;
+		if (bNew) {
+			rows.costs.assign(vertexCount, INFINITE);
+			rows.predecessors.assign(vertexCount, NONE);
+			rows.splits.assign(vertexCount, 0);
+			buildRow(subset, rows.costs.data(), rows.predecessors.data(), rows.splits.data());
 		}
-
-		int32_t count1 = 0;
-		int32_t count2 = 0;
-
-		// 4. For each node (J)...
-		for (uint128_t nodeMaskJ : allNodes) {
-			int32_t minDistance = MAX_INT;
-
-			// 5. Remove a single terminal (E) from the subset (D)
-			// and find the minimum of distance(E,J) + distance(D-E,J)
-			for (uint64_t terminalE : terminalPositions) {
-				uint128_t subsetDMinusEMask = {subsetD ^ terminalE, 0};
-				uint128_t terminalEMask = {terminalE, 0};
-
-				auto itDMinusE = dp.find(subsetDMinusEMask);
-				if (itDMinusE == dp.end()) continue;
-				auto itDMinusEtoJ = itDMinusE->second.find(nodeMaskJ);
-				if (itDMinusEtoJ == itDMinusE->second.end()) continue;
-				int32_t distanceDMinusEToJ = itDMinusEtoJ->second;
-
-				auto itE = dp.find(terminalEMask);
-				if (itE == dp.end()) continue;
-				auto itEtoJ = itE->second.find(nodeMaskJ);
-				if (itEtoJ == itE->second.end()) continue;
-				int32_t distanceEToJ = itEtoJ->second;
-
-				if (distanceDMinusEToJ != MAX_INT && distanceEToJ != MAX_INT)
-					minDistance = std::min(minDistance, distanceDMinusEToJ + distanceEToJ);
+		return {rows.predecessors.data(), rows.splits.data()};
+	};
+
+	std::vector<int32_t> cellAspects(CellIndex::COUNT, -1);
+	bool bConflict = false;
+	auto addSubtree = [&](auto& self, uint64_t subsetD, int32_t vertex) -> void {
+		while (true) {
+			int32_t cell = vertex / aspectCount;
+			int32_t aspectId = vertex % aspectCount;
+			if (!(graph.GetPlacementMask() & CellIndex::ToMask(cell))) {
+				if (cellAspects[cell] != -1 && cellAspects[cell] != aspectId) bConflict = true;
+				cellAspects[cell] = aspectId;
 			}
 
-			++count1;
-			if (minDistance == MAX_INT) continue;
-			++count2;
-
-			// 6. For each node (I), dp[D][I] = min(dp[D][I], dp[J][I] + minDistance)
-			uint128_t subsetDMask = {subsetD, 0};
-			// Ensure dp[subsetDMask] exists (needs to be written to). Use reference to reduce lookups.
-			std::unordered_map<uint128_t, int32_t>& dpSubsetDMap = dp[subsetDMask];
-
-			// Instead of iterating over allNodes, iterate only over dp[nodeMaskJ]'s keys
-			auto itDpJ = dp.find(nodeMaskJ);
-			if (itDpJ == dp.end()) continue;
-			std::unordered_map<uint128_t, int32_t>& dpJMap = itDpJ->second;
-
-			for (const auto& [nodeMaskI, dpJtoI] : dpJMap) {
-				
-				// find current dp[D][I] if present
-				auto itDpDtoI = dpSubsetDMap.find(nodeMaskI);
-				int32_t dpDtoI = itDpDtoI == dpSubsetDMap.end() ? MAX_INT : itDpDtoI->second;
-
-				// Candidate cost
-				// if dpJtoI is MAX_INT, it's not useful; but dpJMap values are actual entries, so this is safe.
-				int32_t candidate = dpJtoI == MAX_INT ? MAX_INT : dpJtoI + minDistance;
-				if (candidate < dpDtoI) dpSubsetDMap[nodeMaskI] = candidate;
+			auto [predecessors, splits] = getBackPointers(subsetD);
+			if (predecessors[vertex] != NONE) {
+				vertex = predecessors[vertex];
+				continue;
 			}
-		}
-	}
 
-	// Break down the mask into an iterable list of terminal positions
-	std::vector<uint64_t> fullTerminalPositions;
-	for (int32_t i = 0; i < 64; ++i) {
-		if (fullTerminalMask & (1ULL << i)) fullTerminalPositions.push_back(1ULL << i);
-	}
+			// Without a predecessor, a single terminal's tree has reached the terminal
+			if (std::has_single_bit(subsetD)) return;
 
-	// 7. For each node (J)...
-	uint128_t rootTerminalMask = Solver::GetMask(rootTerminal, 0);
-	int32_t steinerDistance = MAX_INT;
-	auto itRoot = dp.find(rootTerminalMask);
-	if (itRoot == dp.end()) throw std::runtime_error("Root terminal not found");
-
-	for (uint128_t nodeMaskJ : allNodes) {
-		int32_t minDistance = MAX_INT;
-
-		// 8. Remove a single terminal (E) from the subset (D)
-		// and find the minimum of distance(E,J) + distance(D-E,J)
-		for (uint64_t terminalE : fullTerminalPositions) {
-			uint128_t subsetDMinusEMask = {fullTerminalMask ^ terminalE, 0};
-			uint128_t terminalEMask = {terminalE, 0};
-
-			auto itDMinusE = dp.find(subsetDMinusEMask);
-			auto itE = dp.find(terminalEMask);
-			if (itDMinusE == dp.end() || itE == dp.end()) continue;
-			
-			auto itDMinusEtoJ = itDMinusE->second.find(nodeMaskJ);
-			auto itEtoJ = itE->second.find(nodeMaskJ);
-			if (itDMinusEtoJ == itDMinusE->second.end() || itEtoJ == itE->second.end()) continue;
-			
-			int32_t distanceDMinusEtoJ = itDMinusEtoJ->second;
-			int32_t distanceEtoJ = itEtoJ->second;
-
-			if (distanceDMinusEtoJ != MAX_INT && distanceEtoJ != MAX_INT)
-				minDistance = std::min(minDistance, distanceDMinusEtoJ + distanceEtoJ);
+			uint64_t subsetE = splits[vertex];
+			self(self, subsetE, vertex);
+			self(self, subsetD ^ subsetE, vertex);
+			return;
 		}
+	};
 
-		// 9. Find the minimum of dp[root][J] + min(dp[D-E][J] + dp[E][J])
-		auto itRootToJ = itRoot->second.find(nodeMaskJ);
-		if (itRootToJ == itRoot->second.end()) continue;
-		int32_t distanceRootToJ = itRootToJ->second;
+	addSubtree(addSubtree, fullSubset, rootVertex);
+	if (bConflict || options.HasExpired()) return false;
 
-		if (distanceRootToJ != MAX_INT && minDistance != MAX_INT)
-			steinerDistance = std::min(steinerDistance, distanceRootToJ + minDistance);
+	// Only a tree that the board can hold, that reaches every terminal and that costs what the DP says is this
+	// solver's answer. Anything else would pass for an exact result that it is not.
+	std::vector<Solver::Placement> tree;
+	for (int32_t cell = 0; cell < CellIndex::COUNT; ++cell) {
+		if (cellAspects[cell] != -1) tree.push_back({CellIndex::ToHex(cell), cellAspects[cell]});
 	}
+	if (static_cast<int32_t>(tree.size()) != steinerDistance || !Solver::IsValidTree(graph, tree)) return false;
 
-	std::cout << "Steiner distance: " << steinerDistance << std::endl;
-
-	return steinerDistance < MAX_INT;
+	placements.insert(placements.end(), tree.begin(), tree.end());
+	return true;
 }
 
-void TCSolver::DreyfusWagner::Dijkstra(
+void TCSolver::DreyfusWagner::Propagate(
 	const Graph& graph,
-	const std::unordered_set<Hex>& initialPositions,
-	std::unordered_map<uint128_t, std::unordered_map<uint128_t, int32_t>>& dp,
-	std::unordered_map<uint128_t, uint128_t>& parents,
-	std::unordered_set<uint128_t>& allNodes
+	uint8_t* row,
+	int32_t* predecessors,
+	const Solver::Options& options
 ) {
-	static constexpr int32_t MAX_INT = std::numeric_limits<int32_t>::max();
-
-	std::priority_queue<State> openSet;
-
-	const std::unordered_set<Hex>& terminals = graph.GetTerminals();
-	const std::vector<Aspect>& aspects = graph.GetConfig().GetAspects();
-	uint64_t placementMask = graph.GetPlacementMask();
-
-	// TODO: parallelize
-	for (Hex terminalPosition : initialPositions) {
-		int32_t terminalAspectId = graph.At(terminalPosition).GetAspectId();
-		openSet.push({
-			0,
-			terminalAspectId,
-			terminalPosition,
-			placementMask
-		});
+	static constexpr int32_t INFINITE = SubsetTable::INFINITE;
+
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t aspectCount = links.GetAspectCount();
+	const int32_t gridSize = graph.GetSideLength();
+	const uint64_t placementMask = graph.GetPlacementMask();
+	const int32_t vertexCount = CellIndex::GetCellCount(gridSize) * aspectCount;
+
+	Solver::Arena::Scope arena;
+	Solver::BucketQueue<int32_t> openSet(arena.GetResource());
+	for (int32_t vertex = 0; vertex < vertexCount; ++vertex) {
+		if (row[vertex] != INFINITE) openSet.Push(row[vertex], vertex);
+	}
 
-		uint128_t pureTerminalMask = Solver::GetMask(terminalPosition, 0);
-		uint128_t terminalNodeMask = Solver::GetMask(placementMask, terminalAspectId);
-
-		// Ensure inner maps exist and reserve a bit. Needs more testing to figure out heuristic reserve amount
-		std::unordered_map<uint128_t, int32_t>& dpPure = dp[pureTerminalMask];
-		dpPure.reserve(1024);
-		std::unordered_map<uint128_t, int32_t>& dpTerminal = dp[terminalNodeMask];
-		dpTerminal.reserve(1024);
-
-		dp[pureTerminalMask][terminalNodeMask] = 0;
-		dp[terminalNodeMask][terminalNodeMask] = 0;
-
-		while (!openSet.empty()) {
-			State currentState = openSet.top();
-			openSet.pop();
-
-			for (const Hex& neighbor : currentState.position.GetNeighboringPositions()) {
-				if (Hex::Distance(neighbor, Hex::ZERO) >= graph.GetSideLength()) continue;
-
-				uint64_t neighborPositionMask = Graph::HEX_ENCODINGS.at(neighbor);
-				uint64_t combinedMask = currentState.placementMask | neighborPositionMask;
-
-				if (currentState.placementMask & neighborPositionMask) {
-					// If we're not looking at a terminal (aka backtracking)
-					if (!terminals.contains(neighbor)) continue;
-
-					int32_t existingAspect = graph.At(neighbor).GetAspectId();
-					if (!aspects[currentState.aspectId].GetLinks().contains(existingAspect)) continue;
-
-					uint128_t neighborNodeMask = Solver::GetMask(combinedMask, existingAspect);
-					auto itPureToNeighbor = dpPure.find(neighborNodeMask);
-					int32_t dpCost = itPureToNeighbor == dpPure.end() ? MAX_INT : itPureToNeighbor->second;
-
-					int32_t cost = currentState.cost; // Don't add anything -- Using an existing aspect not placed by us
-					if (dpCost <= cost) continue;
-
-					dpPure[neighborNodeMask] = cost;
-					dp[neighborNodeMask][terminalNodeMask] = cost;
-					auto dpNeighbor = dp.find(neighborNodeMask);
-					if (dpNeighbor == dp.end()) throw std::runtime_error("dp neighbor not found");
-
-					uint128_t parentMask = Solver::GetMask(currentState.placementMask, currentState.aspectId);
-					parents[neighborNodeMask] = parentMask;
-
-					// Fill reverse cumulative costs along parent chain
-					while (parentMask != terminalNodeMask) {
-						dpNeighbor->second[parentMask] = cost - dpPure[parentMask];
-						parentMask = parents[parentMask];
-					}
-
-					openSet.push({
-						cost,
-						existingAspect,
-						neighbor,
-						combinedMask
-					});
-					allNodes.insert(neighborNodeMask);
-				} else {
-					for (int32_t aspectId : aspects[currentState.aspectId].GetLinks()) {
-						uint128_t neighborNodeMask = Solver::GetMask(combinedMask, aspectId);
-						
-						auto itPureToNeighbor = dpPure.find(neighborNodeMask);
-						int32_t dpCost = itPureToNeighbor == dpPure.end() ? MAX_INT : itPureToNeighbor->second;
-
-						int32_t cost = currentState.cost + 1;
-						if (dpCost <= cost) continue;
-
-						dpPure[neighborNodeMask] = cost;
-						dp[neighborNodeMask][terminalNodeMask] = cost;
-						auto dpNeighbor = dp.find(neighborNodeMask);
-						if (dpNeighbor == dp.end()) throw std::runtime_error("dp neighbor not found");
-
-						uint128_t parentMask = Solver::GetMask(currentState.placementMask, currentState.aspectId);
-						parents[neighborNodeMask] = parentMask;
-
-						// Fill reverse cumulative costs along parent chain
-						while (parentMask != terminalNodeMask) {
-							dpNeighbor->second[parentMask] = cost - dpPure[parentMask];
-							parentMask = parents[parentMask];
-						}
-
-						openSet.push({
-							cost,
-							aspectId,
-							neighbor,
-							combinedMask
-						});
-						allNodes.insert(neighborNodeMask);
-					}
-				}
-			}
+	uint64_t pushes = openSet.size();
+	uint64_t expanded = 0;
+	uint64_t stale = 0;
+	while (!openSet.empty()) {
+		if (++expanded % 1024 == 0 && options.HasExpired()) break;
+
+		int32_t cost = openSet.PeekKey();
+		int32_t vertex = openSet.Pop();
+		if (cost != row[vertex]) {
+			++stale;
+			continue;
 		}
-	}
-}
 
-constexpr TCSolver::DreyfusWagner::TerminalSubsets_t TCSolver::DreyfusWagner::GetTerminalSubsets(
-	uint64_t terminalMask
-) noexcept {
-	int32_t numTerminals = 0;
-	std::vector<uint64_t> terminalPositions;
-	for (int32_t i = 0; i < 64; ++i) {
-		if (terminalMask & (1ULL << i)) {
-			terminalPositions.push_back(i);
-			++numTerminals;
+		// Entering a vertex pays for its own cell, which is free for a terminal
+		auto relax = [&](int32_t neighbor, int32_t neighborCost) {
+			if (neighborCost >= row[neighbor]) return;
+			row[neighbor] = neighborCost;
+			if (predecessors) predecessors[neighbor] = vertex;
+			openSet.Push(neighborCost, neighbor);
+			++pushes;
+		};
+
+		int32_t cell = vertex / aspectCount;
+		int32_t aspectId = vertex % aspectCount;
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+			if (placementMask & CellIndex::ToMask(neighborCell)) {
+				if (!graph.IsTerminal(neighborCell)) continue;
+
+				int32_t existingAspect = graph.GetAspectAt(neighborCell);
+				if (links.IsLinked(aspectId, existingAspect)) relax(neighborCell * aspectCount + existingAspect, cost);
+			} else {
+				for (int32_t linkedAspect : links.GetLinks(aspectId))
+					relax(neighborCell * aspectCount + linkedAspect, cost + 1);
+			}
 		}
 	}
 
-	TerminalSubsets_t subsets;
-	for (int32_t i = 1; i <= (1 << numTerminals) - 1; ++i) {
-		uint64_t subsetMask = 0;
-		for (int32_t j = 0; j < numTerminals; ++j) {
-			if (i & (1 << j)) subsetMask |= (1 << terminalPositions[j]);
-		}
+	options.Count(&Solver::Counters::statesExpanded, expanded - stale);
+	options.Count(&Solver::Counters::stalePops, stale);
+	options.Count(&Solver::Counters::queuePushes, pushes);
+}
 
-		if (subsetMask != 0 && std::popcount(subsetMask) > 1) subsets.emplace(subsetMask);
-	}
+TCSolver::DreyfusWagner::SubsetTable::SubsetTable(size_t rowCount, size_t columnCount, bool bBackPointers) :
+	columnCount(columnCount),
+	bBackPointers(bBackPointers),
+	costs(rowCount * columnCount, INFINITE) {
+	if (!bBackPointers) return;
 
-	return subsets;
+	predecessors.assign(rowCount * columnCount, NONE);
+	splits.assign(rowCount * columnCount, 0);
 }
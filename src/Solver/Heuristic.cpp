@@ -0,0 +1,291 @@
+#include <atomic>
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+#include "Arena.hpp"
+#include "Heuristic.hpp"
+#include "ThreadPool.hpp"
+
+TCSolver::Heuristic::Board::Board(const Graph& graph) noexcept : placedMask(0) {
+	// Only terminals take part in the tree. Every other node of the graph is an obstacle, like a hole.
+	aspects.fill(-1);
+	for (uint64_t terminals = graph.GetTerminalMask(); terminals; terminals &= terminals - 1) {
+		int32_t cell = std::countr_zero(terminals);
+		aspects[cell] = graph.GetAspectAt(cell);
+	}
+}
+
+uint64_t TCSolver::Heuristic::GetComponent(const Graph& graph, const Board& board, int32_t cell) {
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t gridSize = graph.GetSideLength();
+	const uint64_t occupiedMask = graph.GetTerminalMask() | board.placedMask;
+
+	Solver::Arena::Scope arena;
+	uint64_t component = CellIndex::ToMask(cell);
+	std::pmr::vector<int32_t> pending({cell}, arena.GetResource());
+	while (!pending.empty()) {
+		int32_t current = pending.back();
+		pending.pop_back();
+
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, current)) {
+			uint64_t neighborMask = CellIndex::ToMask(neighborCell);
+			if (!(occupiedMask & neighborMask) || (component & neighborMask)) continue;
+			if (!links.IsLinked(board.aspects[current], board.aspects[neighborCell])) continue;
+
+			component |= neighborMask;
+			pending.push_back(neighborCell);
+		}
+	}
+
+	return component;
+}
+
+bool TCSolver::Heuristic::Connect(
+	const Graph& graph,
+	Board& board,
+	uint64_t sourceMask,
+	uint64_t targetMask,
+	const Solver::Options& options
+) {
+	static constexpr int32_t NONE = -1;
+	static constexpr int32_t INFINITE = std::numeric_limits<int32_t>::max();
+
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t aspectCount = links.GetAspectCount();
+	const int32_t gridSize = graph.GetSideLength();
+	const uint64_t occupiedMask = graph.GetTerminalMask() | board.placedMask;
+	const uint64_t obstacleMask = graph.GetPlacementMask() & ~graph.GetTerminalMask();
+
+	// Cells a path found earlier needed twice with different aspects. They are left out of every following search, so
+	// each retry loses one more cell, and the loop ends once a path fits on the board or none is left.
+	uint64_t conflictMask = 0;
+	while (true) {
+		const uint64_t blockedMask = obstacleMask | conflictMask;
+
+		// 0-1 BFS over (cell, aspect) vertices. Entering an empty cell costs 1, entering an occupied one is free.
+		Solver::Arena::Scope arena;
+		std::pmr::vector<int32_t> distances(CellIndex::COUNT * aspectCount, INFINITE, arena.GetResource());
+		std::pmr::vector<int32_t> parents(CellIndex::COUNT * aspectCount, NONE, arena.GetResource());
+		std::pmr::deque<int32_t> openSet(arena.GetResource());
+
+		for (uint64_t sources = sourceMask; sources; sources &= sources - 1) {
+			int32_t cell = std::countr_zero(sources);
+			int32_t vertex = cell * aspectCount + board.aspects[cell];
+			distances[vertex] = 0;
+			openSet.push_back(vertex);
+		}
+
+		int32_t target = NONE;
+		uint64_t expanded = 0;
+		uint64_t pushes = openSet.size();
+		while (!openSet.empty()) {
+			int32_t vertex = openSet.front();
+			openSet.pop_front();
+			++expanded;
+
+			int32_t cell = vertex / aspectCount;
+			int32_t aspectId = vertex % aspectCount;
+			if (targetMask & CellIndex::ToMask(cell)) {
+				target = vertex;
+				break;
+			}
+
+			auto relax = [&](int32_t neighbor, int32_t weight) {
+				if (distances[neighbor] <= distances[vertex] + weight) return;
+				distances[neighbor] = distances[vertex] + weight;
+				parents[neighbor] = vertex;
+				if (weight == 0) openSet.push_front(neighbor);
+				else openSet.push_back(neighbor);
+				++pushes;
+			};
+
+			for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+				uint64_t neighborMask = CellIndex::ToMask(neighborCell);
+				if (blockedMask & neighborMask) continue;
+
+				if (occupiedMask & neighborMask) {
+					int32_t existingAspect = board.aspects[neighborCell];
+					if (links.IsLinked(aspectId, existingAspect)) relax(neighborCell * aspectCount + existingAspect, 0);
+				} else {
+					for (int32_t linkedAspect : links.GetLinks(aspectId))
+						relax(neighborCell * aspectCount + linkedAspect, 1);
+				}
+			}
+		}
+
+		options.Count(&Solver::Counters::statesExpanded, expanded);
+		options.Count(&Solver::Counters::queuePushes, pushes);
+		if (target == NONE) return false;
+
+		// The path may pass the same empty cell twice with different aspects, which the board cannot hold
+		Board connected = board;
+		int32_t conflictCell = NONE;
+		for (int32_t vertex = target; vertex != NONE; vertex = parents[vertex]) {
+			int32_t cell = vertex / aspectCount;
+			int32_t aspectId = vertex % aspectCount;
+			if (occupiedMask & CellIndex::ToMask(cell)) continue;
+			if (connected.placedMask & CellIndex::ToMask(cell) && connected.aspects[cell] != aspectId) {
+				conflictCell = cell;
+				break;
+			}
+
+			connected.aspects[cell] = aspectId;
+			connected.placedMask |= CellIndex::ToMask(cell);
+		}
+
+		if (conflictCell != NONE) {
+			conflictMask |= CellIndex::ToMask(conflictCell);
+			continue;
+		}
+
+		board = connected;
+		return true;
+	}
+}
+
+bool TCSolver::Heuristic::Grow(const Graph& graph, Board& board, int32_t rootCell, const Solver::Options& options) {
+	while (true) {
+		uint64_t tree = GetComponent(graph, board, rootCell);
+		uint64_t remaining = graph.GetTerminalMask() & ~tree;
+		if (!remaining) return true;
+
+		// Reaching any piece already hanging off an unconnected terminal is as good as reaching the terminal
+		uint64_t targetMask = 0;
+		for (; remaining; remaining &= remaining - 1) {
+			int32_t terminal = std::countr_zero(remaining);
+			if (!(targetMask & CellIndex::ToMask(terminal))) targetMask |= GetComponent(graph, board, terminal);
+		}
+
+		if (!Connect(graph, board, tree, targetMask, options)) return false;
+	}
+}
+
+void TCSolver::Heuristic::Prune(const Graph& graph, Board& board, int32_t rootCell) {
+	const uint64_t terminalMask = graph.GetTerminalMask();
+
+	bool bChanged = true;
+	while (bChanged) {
+		bChanged = false;
+		for (uint64_t placed = board.placedMask; placed; placed &= placed - 1) {
+			uint64_t cellMask = placed & -placed;
+
+			board.placedMask &= ~cellMask;
+			if ((GetComponent(graph, board, rootCell) & terminalMask) == terminalMask) {
+				board.aspects[std::countr_zero(cellMask)] = -1;
+				bChanged = true;
+			} else {
+				board.placedMask |= cellMask;
+			}
+		}
+	}
+}
+
+void TCSolver::Heuristic::ExchangeKeyPaths(
+	const Graph& graph,
+	Board& board,
+	int32_t rootCell,
+	const Solver::Options& options
+) {
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t gridSize = graph.GetSideLength();
+
+	auto getDegree = [&](const Board& tree, int32_t cell) {
+		const uint64_t occupiedMask = graph.GetTerminalMask() | tree.placedMask;
+		int32_t degree = 0;
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+			if (!(occupiedMask & CellIndex::ToMask(neighborCell))) continue;
+			if (links.IsLinked(tree.aspects[cell], tree.aspects[neighborCell])) ++degree;
+		}
+		return degree;
+	};
+
+	bool bImproved = true;
+	while (bImproved) {
+		bImproved = false;
+		for (uint64_t placed = board.placedMask; placed; placed &= placed - 1) {
+			// The board is a whole tree between exchanges, so it can be returned as it is once the deadline passes
+			if (options.HasExpired()) return;
+
+			int32_t cell = std::countr_zero(placed);
+			if (!(board.placedMask & CellIndex::ToMask(cell)) || getDegree(board, cell) > 2) continue;
+
+			// The key path through this cell: every placement reachable through other placements of degree 2 or less
+			uint64_t keyPath = CellIndex::ToMask(cell);
+			std::vector<int32_t> pending = {cell};
+			while (!pending.empty()) {
+				int32_t current = pending.back();
+				pending.pop_back();
+
+				for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, current)) {
+					uint64_t neighborMask = CellIndex::ToMask(neighborCell);
+					if (!(board.placedMask & neighborMask) || (keyPath & neighborMask)) continue;
+					if (!links.IsLinked(board.aspects[current], board.aspects[neighborCell])) continue;
+					if (getDegree(board, neighborCell) > 2) continue;
+
+					keyPath |= neighborMask;
+					pending.push_back(neighborCell);
+				}
+			}
+
+			Board candidate = board;
+			candidate.placedMask &= ~keyPath;
+			for (uint64_t removed = keyPath; removed; removed &= removed - 1)
+				candidate.aspects[std::countr_zero(removed)] = -1;
+
+			if (!Grow(graph, candidate, rootCell, options)) continue;
+			Prune(graph, candidate, rootCell);
+
+			if (candidate.GetCost() < board.GetCost()) {
+				board = candidate;
+				bImproved = true;
+			}
+		}
+	}
+}
+
+bool TCSolver::Heuristic::Solve(
+	const Graph& graph,
+	std::vector<Solver::Placement>& placements,
+	const Solver::Options& options
+) {
+	std::vector<int32_t> terminalCells;
+	for (uint64_t terminals = graph.GetTerminalMask(); terminals; terminals &= terminals - 1)
+		terminalCells.push_back(std::countr_zero(terminals));
+	if (terminalCells.size() < 2) return !terminalCells.empty();
+
+	Solver::PhaseTimer timer(options, &Solver::Counters::searchNanoseconds);
+
+	// One independent run per starting terminal
+	std::vector<Board> boards(terminalCells.size(), Board(graph));
+	std::vector<uint8_t> bSolved(terminalCells.size(), false);
+	std::atomic<bool> bAnySolved = false;
+
+	ThreadPool pool(options.threadCount);
+	pool.ParallelFor(terminalCells.size(), [&](size_t i) {
+		// Runs already finished still count once the deadline passes. Until one succeeds, new ones keep starting, so
+		// there is an answer however early the deadline.
+		if (bAnySolved && options.HasExpired()) return;
+		if (!Grow(graph, boards[i], terminalCells[i], options)) return;
+		Prune(graph, boards[i], terminalCells[i]);
+		ExchangeKeyPaths(graph, boards[i], terminalCells[i], options);
+		bSolved[i] = true;
+		bAnySolved = true;
+	});
+
+	timer.Switch(&Solver::Counters::combineNanoseconds);
+
+	// Lowest cost, then lowest starting cell, so the answer does not depend on the thread count
+	int32_t best = -1;
+	for (int32_t i = 0; i < static_cast<int32_t>(terminalCells.size()); ++i) {
+		if (bSolved[i] && (best == -1 || boards[i].GetCost() < boards[best].GetCost())) best = i;
+	}
+	if (best == -1) return false;
+
+	for (uint64_t placed = boards[best].placedMask; placed; placed &= placed - 1) {
+		int32_t cell = std::countr_zero(placed);
+		placements.push_back({CellIndex::ToHex(cell), boards[best].aspects[cell]});
+	}
+
+	return true;
+}
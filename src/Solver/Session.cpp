@@ -0,0 +1,101 @@
+#include <chrono>
+#include <format>
+#include <stdexcept>
+
+#include "Session.hpp"
+
+TCSolver::Solver::Session::Session(
+	std::shared_ptr<const Catalog> catalog,
+	int32_t gridSize,
+	const std::vector<Node>& terminals,
+	std::string_view solverName,
+	const Options& options,
+	SolutionCache* cache
+) : catalog(std::move(catalog)), gridSize(gridSize), solverName(solverName), options(options), cache(cache) {
+	if (gridSize < 1 || gridSize > CellIndex::MAX_GRID_SIZE)
+		throw std::runtime_error(std::format("Unsupported grid size: {}", gridSize));
+
+	cells.fill(EMPTY);
+	for (const Node& terminal : terminals) {
+		int32_t cell = GetCell(terminal.GetPosition());
+		cells[cell] = terminal.GetAspectId() == -1 ? HOLE : terminal.GetAspectId();
+	}
+}
+
+void TCSolver::Solver::Session::SetTerminal(Hex position, int32_t aspectId) {
+	SetCell(GetCell(position), aspectId);
+}
+
+void TCSolver::Solver::Session::SetHole(Hex position) {
+	SetCell(GetCell(position), HOLE);
+}
+
+void TCSolver::Solver::Session::Clear(Hex position) {
+	SetCell(GetCell(position), EMPTY);
+}
+
+void TCSolver::Solver::Session::MoveTerminal(Hex from, Hex to) {
+	int32_t fromCell = GetCell(from);
+	int32_t toCell = GetCell(to);
+	if (cells[fromCell] == EMPTY)
+		throw std::runtime_error(std::format("Nothing to move at ({}, {})", from.i, from.j));
+	if (fromCell == toCell) return;
+
+	int32_t content = cells[fromCell];
+	SetCell(fromCell, EMPTY);
+	SetCell(toCell, content);
+}
+
+const TCSolver::Solver::Solution& TCSolver::Solver::Session::Solve() {
+	if (bSolvedBefore && !addedHoles && !bOtherEdits) return solution;
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	std::vector<Node> nodes;
+	for (int32_t cell = 0; cell < CellIndex::GetCellCount(gridSize); ++cell) {
+		if (cells[cell] != EMPTY) nodes.emplace_back(CellIndex::ToHex(cell), cells[cell]);
+	}
+
+	// The graph points into the config it was built from, so it goes first
+	graph.reset();
+	config = std::make_unique<Config>(catalog, gridSize, std::move(nodes));
+	graph = std::make_unique<Graph>(*config);
+	AddNodes(*graph, *config);
+
+	uint64_t placedMask = 0;
+	for (const Placement& placement : solution.placements)
+		placedMask |= CellIndex::ToMask(CellIndex::FromHex(placement.position));
+
+	if (bSolvedBefore && !bOtherEdits && solution.bExact && !(addedHoles & placedMask)) {
+		// Every tree on the new board also fits the old one, so the old optimum, which still fits, is still optimal
+		Stats stats;
+		stats.solver = solution.stats.solver;
+		stats.bCached = true;
+		stats.time = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::high_resolution_clock::now() - start
+		);
+		solution.stats = std::move(stats);
+	} else {
+		solution = TCSolver::Solver::Solve(*graph, solverName, options, cache ? cache : &ownCache);
+	}
+
+	bSolvedBefore = true;
+	addedHoles = 0;
+	bOtherEdits = false;
+	return solution;
+}
+
+int32_t TCSolver::Solver::Session::GetCell(Hex position) const {
+	int32_t cell = CellIndex::FromHex(position);
+	if (cell == CellIndex::INVALID || cell >= CellIndex::GetCellCount(gridSize))
+		throw std::runtime_error(std::format("Position ({}, {}) is outside the grid", position.i, position.j));
+	return cell;
+}
+
+void TCSolver::Solver::Session::SetCell(int32_t cell, int32_t content) {
+	if (cells[cell] == content) return;
+
+	if (content == HOLE && cells[cell] == EMPTY) addedHoles |= CellIndex::ToMask(cell);
+	else bOtherEdits = true;
+	cells[cell] = content;
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <filesystem>
+#include <format>
+
+#include "Binary.hpp"
+#include "SolutionCache.hpp"
+
+namespace {
+
+// "TCSL", and the layout version of cache files
+constexpr uint32_t CACHE_MAGIC = 0x4C534354;
+constexpr uint32_t CACHE_VERSION = 1;
+constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t);
+
+}
+
+TCSolver::Solver::SolutionCache::SolutionCache(const std::string& filename) {
+	size_t validSize = 0;
+
+	{
+		Binary::MappedFile file(filename);
+		Binary::Reader header(file.GetData(), file.GetSize());
+		if (
+			file.IsOpen()
+			&& file.GetSize() >= HEADER_SIZE
+			&& header.Read<uint32_t>() == CACHE_MAGIC
+			&& header.Read<uint32_t>() == CACHE_VERSION
+		) {
+			// Records are length-prefixed. Anything after the last complete one is a write cut short.
+			validSize = HEADER_SIZE;
+			while (file.GetSize() - validSize >= sizeof(uint64_t)) {
+				Binary::Reader lengthReader(file.GetData() + validSize, sizeof(uint64_t));
+				uint64_t length = lengthReader.Read<uint64_t>();
+				if (length > file.GetSize() - validSize - sizeof(uint64_t)) break;
+
+				try {
+					Binary::Reader reader(file.GetData() + validSize + sizeof(uint64_t), length);
+					std::string key(reader.ReadString());
+					Entry entry;
+					entry.solver = reader.ReadString();
+					uint32_t count = reader.Read<uint32_t>();
+					for (uint32_t i = 0; i < count; ++i) {
+						int8_t cell = reader.Read<int8_t>();
+						int32_t aspectId = reader.Read<int32_t>();
+						if (cell < 0 || cell >= CellIndex::COUNT) throw std::runtime_error("Corrupt cache entry");
+						entry.placements.push_back({CellIndex::ToHex(cell), aspectId});
+					}
+					entries.insert_or_assign(std::move(key), std::move(entry));
+				} catch (const std::runtime_error&) {
+					break;
+				}
+
+				validSize += sizeof(uint64_t) + length;
+			}
+		}
+	}
+
+	if (validSize == 0) {
+		log.open(filename, std::ios::binary | std::ios::trunc);
+		Binary::Writer header;
+		header.Write(CACHE_MAGIC);
+		header.Write(CACHE_VERSION);
+		log.write(header.GetBuffer().data(), header.GetBuffer().size());
+	} else {
+		std::filesystem::resize_file(filename, validSize);
+		log.open(filename, std::ios::binary | std::ios::app);
+	}
+
+	if (!log.is_open()) throw std::runtime_error(std::format("Could not open solution cache for writing: {}", filename));
+	log.flush();
+}
+
+std::optional<TCSolver::Solver::SolutionCache::Entry> TCSolver::Solver::SolutionCache::Find(const Graph& graph) {
+	auto [key, symmetry] = GetSignature(graph);
+
+	std::lock_guard lock(mutex);
+	const auto it = entries.find(key);
+	if (it == entries.end()) return std::nullopt;
+
+	Entry entry = it->second;
+	for (Placement& placement : entry.placements)
+		placement.position = CellIndex::ToHex(Symmetry::INVERSE[symmetry][CellIndex::FromHex(placement.position)]);
+	return entry;
+}
+
+void TCSolver::Solver::SolutionCache::Insert(const Graph& graph, const Entry& entry) {
+	auto [key, symmetry] = GetSignature(graph);
+
+	Entry canonical = entry;
+	for (Placement& placement : canonical.placements)
+		placement.position = CellIndex::ToHex(Symmetry::FORWARD[symmetry][CellIndex::FromHex(placement.position)]);
+
+	Binary::Writer record;
+	record.WriteString(key);
+	record.WriteString(canonical.solver);
+	record.Write<uint32_t>(canonical.placements.size());
+	for (const Placement& placement : canonical.placements) {
+		record.Write<int8_t>(CellIndex::FromHex(placement.position));
+		record.Write<int32_t>(placement.aspectId);
+	}
+
+	std::lock_guard lock(mutex);
+	if (!entries.try_emplace(std::move(key), std::move(canonical)).second || !log.is_open()) return;
+
+	uint64_t length = record.GetBuffer().size();
+	log.write(reinterpret_cast<const char*>(&length), sizeof(length));
+	log.write(record.GetBuffer().data(), record.GetBuffer().size());
+	log.flush();
+}
+
+size_t TCSolver::Solver::SolutionCache::size() {
+	std::lock_guard lock(mutex);
+	return entries.size();
+}
+
+std::pair<std::string, int32_t> TCSolver::Solver::SolutionCache::GetSignature(const Graph& graph) {
+	std::vector<std::pair<int8_t, int32_t>> cells;
+
+	std::string best;
+	int32_t bestSymmetry = 0;
+	for (int32_t symmetry = 0; symmetry < Symmetry::COUNT; ++symmetry) {
+		cells.clear();
+		for (uint64_t placed = graph.GetPlacementMask(); placed; placed &= placed - 1) {
+			int32_t cell = std::countr_zero(placed);
+			int32_t aspectId = graph.IsTerminal(cell) ? graph.GetAspectAt(cell) : -1;
+			cells.emplace_back(Symmetry::FORWARD[symmetry][cell], aspectId);
+		}
+		std::sort(cells.begin(), cells.end());
+
+		Binary::Writer signature;
+		signature.Write<int32_t>(graph.GetSideLength());
+		signature.Write<uint64_t>(graph.GetConfig().GetCatalog().GetHash());
+		for (const auto& [cell, aspectId] : cells) {
+			signature.Write<int8_t>(cell);
+			signature.Write<int32_t>(aspectId);
+		}
+
+		if (symmetry == 0 || signature.GetBuffer() < best) {
+			best = signature.GetBuffer();
+			bestSymmetry = symmetry;
+		}
+	}
+
+	return {best, bestSymmetry};
+}
@@ -0,0 +1,48 @@
+#include <bit>
+
+#include "Solver.hpp"
+
+bool TCSolver::Solver::IsValidTree(const Graph& graph, const std::vector<Placement>& placements) {
+	const LinkTable& links = graph.GetConfig().GetLinks();
+	const int32_t gridSize = graph.GetSideLength();
+
+	std::array<int32_t, CellIndex::COUNT> aspects;
+	aspects.fill(-1);
+	for (uint64_t terminals = graph.GetTerminalMask(); terminals; terminals &= terminals - 1) {
+		int32_t cell = std::countr_zero(terminals);
+		aspects[cell] = graph.GetAspectAt(cell);
+	}
+
+	uint64_t occupiedMask = graph.GetTerminalMask();
+	for (const Placement& placement : placements) {
+		int32_t cell = CellIndex::FromHex(placement.position);
+		if (cell == CellIndex::INVALID || cell >= CellIndex::GetCellCount(gridSize)) return false;
+		if ((graph.GetPlacementMask() | occupiedMask) & CellIndex::ToMask(cell)) return false;
+		if (placement.aspectId < 0 || placement.aspectId >= links.GetAspectCount()) return false;
+
+		aspects[cell] = placement.aspectId;
+		occupiedMask |= CellIndex::ToMask(cell);
+	}
+
+	if (!graph.GetTerminalMask()) return true;
+
+	// Flood from one terminal through linked neighbors, which has to reach all the others
+	int32_t start = std::countr_zero(graph.GetTerminalMask());
+	uint64_t reached = CellIndex::ToMask(start);
+	std::vector<int32_t> pending = {start};
+	while (!pending.empty()) {
+		int32_t cell = pending.back();
+		pending.pop_back();
+
+		for (int32_t neighborCell : CellIndex::GetNeighbors(gridSize, cell)) {
+			uint64_t neighborMask = CellIndex::ToMask(neighborCell);
+			if (!(occupiedMask & neighborMask) || (reached & neighborMask)) continue;
+			if (!links.IsLinked(aspects[cell], aspects[neighborCell])) continue;
+
+			reached |= neighborMask;
+			pending.push_back(neighborCell);
+		}
+	}
+
+	return (reached & graph.GetTerminalMask()) == graph.GetTerminalMask();
+}
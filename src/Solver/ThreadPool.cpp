@@ -0,0 +1,82 @@
+#include <atomic>
+#include <exception>
+
+#include "ThreadPool.hpp"
+
+TCSolver::ThreadPool::ThreadPool(int32_t threadCount) {
+	for (int32_t i = 1; i < threadCount; ++i) workers.emplace_back([this]() { WorkerLoop(); });
+}
+
+TCSolver::ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(mutex);
+		bStopping = true;
+	}
+	condition.notify_all();
+}
+
+void TCSolver::ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task) {
+	std::atomic<size_t> nextIndex = 0;
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	auto drain = [&]() {
+		for (size_t i = nextIndex++; i < count; i = nextIndex++) {
+			try {
+				task(i);
+			} catch (...) {
+				std::lock_guard lock(exceptionMutex);
+				if (!exception) exception = std::current_exception();
+			}
+		}
+	};
+
+	size_t helperCount = std::min(workers.size(), count > 0 ? count - 1 : 0);
+	size_t finishedHelpers = 0;
+	std::mutex finishedMutex;
+	std::condition_variable finishedCondition;
+
+	for (size_t i = 0; i < helperCount; ++i) {
+		Enqueue([&]() {
+			drain();
+			// Notify under the lock, since the caller's stack frame may be gone as soon as it is released
+			std::lock_guard lock(finishedMutex);
+			++finishedHelpers;
+			finishedCondition.notify_one();
+		});
+	}
+
+	drain();
+
+	std::unique_lock lock(finishedMutex);
+	finishedCondition.wait(lock, [&]() { return finishedHelpers == helperCount; });
+
+	if (exception) std::rethrow_exception(exception);
+}
+
+void TCSolver::ThreadPool::Submit(std::function<void()> task) {
+	if (workers.empty()) task();
+	else Enqueue(std::move(task));
+}
+
+void TCSolver::ThreadPool::Enqueue(std::function<void()> task) {
+	{
+		std::lock_guard lock(mutex);
+		tasks.push(std::move(task));
+	}
+	condition.notify_one();
+}
+
+void TCSolver::ThreadPool::WorkerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock, [this]() { return bStopping || !tasks.empty(); });
+			if (bStopping && tasks.empty()) return;
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -1,6 +1,4 @@
-#include <algorithm>
 #include <assert.h>
-#include <stdexcept>
 
 #include "Aspect.hpp"
 
@@ -13,16 +11,4 @@ TCSolver::Aspect::Aspect(int32_t id, const std::string& name, int32_t parent1, i
 {
 	assert(id > -1 && "id must be non-negative");
 	assert(parent1 > -1 && parent2 > -1 && "parent1 and parent2 must be non-negative");
-
-	related.insert(parent1);
-	related.insert(parent2);
-}
-
-void TCSolver::Aspect::AddRelated(int32_t other) {
-	if (other <= -1) throw std::invalid_argument("Related aspect id must be non-negative");
-
-	// Intentionally throw if related already exists
-	if (related.contains(other)) throw std::invalid_argument("Related aspect already exists");
-
-	related.insert(other);
 }
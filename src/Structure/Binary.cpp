@@ -0,0 +1,46 @@
+#include "Binary.hpp"
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+TCSolver::Binary::MappedFile::MappedFile(const std::string& filename) {
+#ifndef _WIN32
+	int descriptor = open(filename.c_str(), O_RDONLY);
+	if (descriptor == -1) return;
+
+	struct stat status;
+	if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+		void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+		if (mapping != MAP_FAILED) {
+			data = static_cast<const std::byte*>(mapping);
+			size = status.st_size;
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	close(descriptor);
+#else
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) return;
+
+	fallback.resize(file.tellg());
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(fallback.data()), fallback.size());
+	if (!file || fallback.empty()) return;
+
+	data = fallback.data();
+	size = fallback.size();
+#endif
+}
+
+TCSolver::Binary::MappedFile::~MappedFile() {
+#ifndef _WIN32
+	if (data != nullptr) munmap(const_cast<std::byte*>(data), size);
+#endif
+}
@@ -0,0 +1,228 @@
+#include <cassert>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#include "Binary.hpp"
+#include "Catalog.hpp"
+
+namespace {
+
+// "TCSC", and the layout version of binary catalogs
+constexpr uint32_t BINARY_MAGIC = 0x43534354;
+constexpr uint32_t BINARY_VERSION = 1;
+
+}
+
+int32_t TCSolver::Catalog::GetAspectIdByName(const std::string& name) const {
+	if (!aspectNames.contains(name)) return -1;
+	int32_t aspectId = aspectNames.at(name);
+
+	assert(aspectId >= 0 && aspectId < aspects.size() && "aspectId out of range");
+
+	return aspectId;
+}
+
+std::shared_ptr<const TCSolver::Catalog> TCSolver::Catalog::GetDefault() {
+	static const std::shared_ptr<const Catalog> catalog = []() {
+		auto defaultCatalog = std::make_shared<Catalog>();
+		defaultCatalog->ParseText(std::string(DEFAULT_YAML));
+		return defaultCatalog;
+	}();
+
+	return catalog;
+}
+
+void TCSolver::Catalog::Load(const std::string& filename) {
+	if (LoadBinary(filename)) return;
+
+	std::string compiledFilename = filename + ".bin";
+	if (std::filesystem::exists(compiledFilename)) {
+		SourceStamp stamp = GetSourceStamp(filename);
+		if (LoadBinary(compiledFilename, &stamp)) return;
+	}
+
+	Parse(filename);
+}
+
+void TCSolver::Catalog::Parse(const std::string& filename) {
+	ParseText(Yaml::ReadFile(filename));
+}
+
+void TCSolver::Catalog::ParseText(std::string content) {
+	ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(content));
+
+	Parse(Yaml::GetNode(tree.rootref(), "aspects", ryml::NodeType::Map));
+}
+
+void TCSolver::Catalog::Parse(const ryml::ConstNodeRef& aspectsYamlNode) {
+	for (const ryml::ConstNodeRef& aspectYamlNode : aspectsYamlNode.children())
+		CreateAspectFromYamlNode(aspectYamlNode);
+
+	links.Build(aspects);
+	UpdateHash();
+}
+
+void TCSolver::Catalog::UpdateHash() noexcept {
+	// FNV-1a over every aspect's name and parents
+	hash = 0xCBF29CE484222325ULL;
+	auto mix = [this](const void* data, size_t size) {
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= static_cast<const uint8_t*>(data)[i];
+			hash *= 0x100000001B3ULL;
+		}
+	};
+
+	for (const Aspect& aspect : aspects) {
+		int32_t parents[2] = {aspect.GetParent1(), aspect.GetParent2()};
+		mix(aspect.GetName().data(), aspect.GetName().size() + 1);
+		mix(parents, sizeof(parents));
+	}
+}
+
+void TCSolver::Catalog::Compile(const std::string& yamlFilename, const std::string& binaryFilename) {
+	Catalog catalog;
+	catalog.Parse(yamlFilename);
+	catalog.Save(binaryFilename, GetSourceStamp(yamlFilename));
+}
+
+TCSolver::Catalog::SourceStamp TCSolver::Catalog::GetSourceStamp(const std::string& yamlFilename) {
+	return {
+		std::filesystem::file_size(yamlFilename),
+		static_cast<int64_t>(std::filesystem::last_write_time(yamlFilename).time_since_epoch().count())
+	};
+}
+
+bool TCSolver::Catalog::LoadBinary(const std::string& filename, const SourceStamp* expected) {
+	Binary::MappedFile file(filename);
+	if (!file.IsOpen()) return false;
+
+	Binary::Reader reader(file.GetData(), file.GetSize());
+	if (file.GetSize() < 2 * sizeof(uint32_t)) return false;
+	if (reader.Read<uint32_t>() != BINARY_MAGIC || reader.Read<uint32_t>() != BINARY_VERSION) return false;
+
+	SourceStamp stamp = reader.Read<SourceStamp>();
+	if (expected && stamp != *expected) return false;
+
+	std::vector<Aspect> loadedAspects;
+	std::unordered_map<std::string, int32_t> loadedNames;
+	LinkTable loadedLinks;
+
+	int32_t aspectCount = reader.Read<int32_t>();
+	loadedAspects.reserve(aspectCount);
+	for (int32_t aspectId = 0; aspectId < aspectCount; ++aspectId) {
+		std::string name(reader.ReadString());
+		int32_t parent1 = reader.Read<int32_t>();
+		int32_t parent2 = reader.Read<int32_t>();
+		int32_t tier = reader.Read<int32_t>();
+		if (parent1 != -1 && (parent1 < 0 || parent2 < 0 || parent1 >= aspectId || parent2 >= aspectId))
+			throw std::runtime_error(std::format("Corrupt binary catalog: {}", filename));
+
+		if (parent1 == -1) loadedAspects.emplace_back(aspectId, name);
+		else loadedAspects.emplace_back(aspectId, name, parent1, parent2, tier);
+		loadedNames.emplace(std::move(name), aspectId);
+	}
+
+	loadedLinks.Read(reader);
+	if (loadedLinks.GetAspectCount() != aspectCount)
+		throw std::runtime_error(std::format("Corrupt binary catalog: {}", filename));
+
+	aspects = std::move(loadedAspects);
+	aspectNames = std::move(loadedNames);
+	links = std::move(loadedLinks);
+	UpdateHash();
+	return true;
+}
+
+void TCSolver::Catalog::Save(const std::string& filename, const SourceStamp& stamp) const {
+	Binary::Writer writer;
+	writer.Write(BINARY_MAGIC);
+	writer.Write(BINARY_VERSION);
+	writer.Write(stamp);
+
+	writer.Write<int32_t>(aspects.size());
+	for (const Aspect& aspect : aspects) {
+		writer.WriteString(aspect.GetName());
+		writer.Write<int32_t>(aspect.GetParent1());
+		writer.Write<int32_t>(aspect.GetParent2());
+		writer.Write<int32_t>(aspect.GetTier());
+	}
+
+	links.Write(writer);
+
+	std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) throw std::runtime_error(std::format("Could not open catalog file for writing: {}", filename));
+	file.write(writer.GetBuffer().data(), writer.GetBuffer().size());
+}
+
+void TCSolver::Catalog::CreateAspectFromYamlNode(const ryml::ConstNodeRef& node) {
+	ryml::ConstNodeRef parent1Node = Yaml::GetNode(node, "parent1", ryml::NodeType::Value);
+	ryml::ConstNodeRef parent2Node = Yaml::GetNode(node, "parent2", ryml::NodeType::Value);
+
+	std::string aspectName = Yaml::GetKeyName(node);
+	if (aspectNames.contains(aspectName))
+		throw std::runtime_error(std::format("Aspect \"{}\" already exists", aspectName));
+
+	if (parent1Node.val_is_null() != parent2Node.val_is_null())
+		throw std::runtime_error(std::format("Expected both parents of \"{}\" to be null or non-null", aspectName));
+
+	// int32_t amount = -1;
+	// if (node.has_child("amount")) {
+	// 	ryml::ConstNodeRef amountNode = Yaml::GetNode(node, "amount", ryml::NodeType::Value);
+	// 	amountNode >> amount;
+	// }
+	// if (amount < -1) throw std::runtime_error(std::format("Expected amount of \"{}\" to be >= -1", aspectName));
+
+	int32_t aspectId = aspects.size();
+
+	// If primal aspect (both parents are null, guaranteed if parent1 is null)
+	if (parent1Node.val_is_null()) {
+		aspects.push_back(Aspect(aspectId, aspectName));
+		aspectNames.try_emplace(aspectName, aspectId);
+		return;
+	}
+	// else compound aspect ...
+
+	std::string parent1Name;
+	std::string parent2Name;
+	parent1Node >> parent1Name;
+	parent2Node >> parent2Name;
+
+	auto parent1It = aspectNames.find(parent1Name);
+	auto parent2It = aspectNames.find(parent2Name);
+
+	if (parent1It == aspectNames.end())
+		throw std::runtime_error(std::format("Could not find parent1 aspect \"{}\" for {}", parent1Name, aspectName));
+
+	if (parent2It == aspectNames.end())
+		throw std::runtime_error(std::format("Could not find parent2 aspect \"{}\" for {}", parent2Name, aspectName));
+
+	if (parent1It->second == parent2It->second)
+		throw std::runtime_error(std::format("Expected parents of \"{}\" to be different aspects", aspectName));
+
+	int32_t tier = 1 + std::max(aspects[parent1It->second].GetTier(), aspects[parent2It->second].GetTier());
+
+	aspects.emplace_back(aspectId, aspectName, parent1It->second, parent2It->second, tier);
+	aspectNames.emplace(aspectName, aspectId);
+}
+
+void TCSolver::Catalog::Print() const {
+	std::cout << "Aspects:\n";
+
+	for (int32_t i = 0; i < aspects.size(); ++i) {
+		const TCSolver::Aspect& aspect = aspects[i];
+		std::cout
+			<< "  " << i << " " << aspect.GetName()
+			<< " (" << aspect.GetTier() << ")";
+
+		if (aspect.GetParent1() == -1) {
+			std::cout << "\n";
+			continue;
+		}
+
+		std::cout
+			<< " = " << aspects[aspect.GetParent1()].GetName() << " + "
+			<< aspects[aspect.GetParent2()].GetName() << "\n";
+	}
+}
@@ -5,7 +5,9 @@
 #include "Graph.hpp"
 
 TCSolver::Graph::Graph(const Config& config) noexcept : config(config), sideLength(config.GetGridSize()) {
-	assert(config.GetGridSize() > 0 && config.GetGridSize() <= 5 && "Grid size must be between 1 and 5");
+	assert(config.GetGridSize() > 0 && config.GetGridSize() <= CellIndex::MAX_GRID_SIZE && "Grid size must be between 1 and 5");
+
+	cellAspects.fill(-1);
 }
 
 const TCSolver::Node& TCSolver::Graph::Add(Hex position, int32_t aspectId) {
@@ -21,6 +23,14 @@ const TCSolver::Node& TCSolver::Graph::Add(Hex position, int32_t aspectId) {
 #endif
 
 	auto [it, bInserted] = nodes.try_emplace(position, position, aspectId);
+
+	// A duplicate keeps the node already there, so the cell tables must keep describing that node too
+	if (bInserted) {
+		int32_t cell = CellIndex::FromHex(position);
+		placementMask |= CellIndex::ToMask(cell);
+		cellAspects[cell] = aspectId;
+	}
+
 	return it->second;
 }
 
@@ -35,14 +45,8 @@ const TCSolver::Node& TCSolver::Graph::At(Hex position) const {
 
 void TCSolver::Graph::AddTerminals(const std::vector<Hex>& newTerminals) {
 	std::copy(newTerminals.begin(), newTerminals.end(), std::inserter(terminals, terminals.begin()));
-}
 
-uint64_t TCSolver::Graph::GetPlacementMask() const {
-	uint64_t mask = 0;
-	for (const std::pair<Hex, Node>& pair : nodes) {
-		mask |= Graph::HEX_ENCODINGS.at(pair.first);
-	}
-	return mask;
+	for (const Hex& terminal : newTerminals) terminalMask |= CellIndex::ToMask(terminal);
 }
 
 void TCSolver::Graph::Print() const {
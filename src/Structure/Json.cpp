@@ -0,0 +1,21 @@
+#include <cstdint>
+#include <format>
+
+#include "Json.hpp"
+
+std::string TCSolver::Json::Quote(std::string_view text) {
+	std::string json = "\"";
+	for (char character : text) {
+		switch (character) {
+			case '"': json += "\\\""; break;
+			case '\\': json += "\\\\"; break;
+			case '\n': json += "\\n"; break;
+			case '\r': json += "\\r"; break;
+			case '\t': json += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(character) >= 0x20) json += character;
+				else json += std::format("\\u{:04x}", static_cast<int32_t>(character));
+		}
+	}
+	return json + "\"";
+}
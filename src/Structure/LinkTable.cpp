@@ -0,0 +1,75 @@
+#include "LinkTable.hpp"
+
+void TCSolver::LinkTable::Build(const std::vector<Aspect>& aspects) {
+	aspectCount = aspects.size();
+	wordsPerRow = (aspectCount + 63) / 64;
+
+	bits.assign(static_cast<size_t>(aspectCount) * wordsPerRow, 0ULL);
+
+	auto link = [this](int32_t lhs, int32_t rhs) {
+		bits[lhs * wordsPerRow + (rhs >> 6)] |= 1ULL << (rhs & 63);
+		bits[rhs * wordsPerRow + (lhs >> 6)] |= 1ULL << (lhs & 63);
+	};
+
+	for (int32_t aspectId = 0; aspectId < aspectCount; ++aspectId) {
+		const Aspect& aspect = aspects[aspectId];
+		if (aspect.GetParent1() == -1) continue;
+		link(aspectId, aspect.GetParent1());
+		link(aspectId, aspect.GetParent2());
+	}
+
+	// Walking the bitset rows in order keeps each id list sorted
+	offsets.assign(aspectCount + 1, 0);
+	ids.clear();
+	for (int32_t aspectId = 0; aspectId < aspectCount; ++aspectId) {
+		offsets[aspectId] = ids.size();
+		for (int32_t other = 0; other < aspectCount; ++other) {
+			if (IsLinked(aspectId, other)) ids.push_back(other);
+		}
+	}
+	offsets[aspectCount] = ids.size();
+
+	// Breadth-first search from every aspect over the link graph
+	chainLengths.assign(static_cast<size_t>(aspectCount) * aspectCount, UNREACHABLE);
+	std::vector<int32_t> frontier;
+	for (int32_t from = 0; from < aspectCount; ++from) {
+		uint8_t* row = chainLengths.data() + static_cast<size_t>(from) * aspectCount;
+		row[from] = 0;
+		frontier.assign(1, from);
+
+		for (size_t i = 0; i < frontier.size(); ++i) {
+			int32_t current = frontier[i];
+			for (int32_t linked : GetLinks(current)) {
+				if (row[linked] != UNREACHABLE) continue;
+				row[linked] = row[current] + 1;
+				frontier.push_back(linked);
+			}
+		}
+	}
+}
+
+void TCSolver::LinkTable::Write(Binary::Writer& writer) const {
+	writer.Write<int32_t>(aspectCount);
+	writer.Write<int32_t>(wordsPerRow);
+	writer.WriteArray(bits);
+	writer.WriteArray(offsets);
+	writer.WriteArray(ids);
+	writer.WriteArray(chainLengths);
+}
+
+void TCSolver::LinkTable::Read(Binary::Reader& reader) {
+	aspectCount = reader.Read<int32_t>();
+	wordsPerRow = reader.Read<int32_t>();
+	reader.ReadArray(bits);
+	reader.ReadArray(offsets);
+	reader.ReadArray(ids);
+	reader.ReadArray(chainLengths);
+
+	if (
+		aspectCount < 0
+		|| bits.size() != static_cast<size_t>(aspectCount) * wordsPerRow
+		|| offsets.size() != static_cast<size_t>(aspectCount) + 1
+		|| offsets.back() != static_cast<int32_t>(ids.size())
+		|| chainLengths.size() != static_cast<size_t>(aspectCount) * aspectCount
+	) throw std::runtime_error("Corrupt link table in binary catalog");
+}
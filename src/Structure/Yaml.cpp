@@ -0,0 +1,57 @@
+#include <format>
+#include <fstream>
+#include <sstream>
+
+#include "Yaml.hpp"
+
+std::string TCSolver::Yaml::ReadFile(const std::string& filename) {
+	std::ifstream file(filename);
+
+	if (!file.is_open()) throw std::runtime_error(std::format("Could not open config file: {}", filename));
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	return buffer.str();
+}
+
+ryml::ConstNodeRef TCSolver::Yaml::GetNode(const ryml::ConstNodeRef& parent, c4::csubstr key, ryml::NodeType type) {
+	if (!parent.is_map())
+		throw std::runtime_error(std::format("Expected \"{}\" to be a map", GetKeyName(parent)));
+
+	if (!parent.has_child(key))
+		throw std::runtime_error(std::format("Could not find \"{}\" in {}", std::string(std::string_view(key)), GetKeyName(parent)));
+
+	ryml::ConstNodeRef child = parent[key];
+
+	bool isMap = child.is_map();
+	bool isSeq = child.is_seq();
+
+	switch(type) {
+		case ryml::NodeType::Map:
+			if (isMap) break;
+			throw std::runtime_error(std::format("Expected \"{}\" to be a map", GetKeyName(child)));
+		case ryml::NodeType::Sequence:
+			if (isSeq) break;
+			throw std::runtime_error(std::format("Expected \"{}\" to be a sequence", GetKeyName(child)));
+		case ryml::NodeType::Value:
+			if (!isMap && !isSeq) break;
+			throw std::runtime_error(std::format("Expected \"{}\" to be a value", GetKeyName(child)));
+	}
+
+	return parent[key];
+}
+
+std::string TCSolver::Yaml::GetKeyName(const ryml::ConstNodeRef& node) {
+	if (node.is_root()) {
+		return "config file";
+	}
+
+	if (!node.has_key()) {
+		std::string nodeType = node.is_map() ? "map" : "sequence";
+		return "element of " + nodeType + " in " + GetKeyName(node.parent());
+	} else {
+		std::string keyName;
+		node >> ryml::key(keyName);
+		return keyName;
+	}
+}
@@ -1,89 +1,277 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
 
-#include "AStar.hpp"
+#include "Catalog.hpp"
 #include "Config.hpp"
-#include "DreyfusWagner.hpp"
+#include "Daemon.hpp"
+#include "Dispatch.hpp"
 #include "Graph.hpp"
 #include "Hex.hpp"
+#include "Json.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * Solves one puzzle file and describes the outcome as a single JSON line. A time limit runs from when the puzzle is
+ * picked up, not from the start of the batch.
+ */
+static std::string SolveFile(
+	const std::string& filename,
+	std::shared_ptr<const TCSolver::Catalog> catalog,
+	std::string_view solverName,
+	const TCSolver::Solver::Options& options,
+	std::chrono::milliseconds timeLimit,
+	TCSolver::Solver::SolutionCache* cache,
+	bool bStats
+) {
+	std::ostringstream line;
+	line << "{\"file\":" << TCSolver::Json::Quote(filename);
+
+	TCSolver::Solver::Options puzzleOptions = options;
+	if (timeLimit > std::chrono::milliseconds::zero())
+		puzzleOptions.deadline = std::chrono::steady_clock::now() + timeLimit;
+
+	try {
+		TCSolver::Config config;
+		config.Parse(filename, catalog);
+
+		TCSolver::Solver::Solution solution = TCSolver::Solver::Solve(config, solverName, puzzleOptions, cache);
+		TCSolver::Solver::WriteJson(line, solution, config.GetCatalog(), bStats);
+	} catch (const std::exception& exception) {
+		line << ",\"solved\":false,\"error\":" << TCSolver::Json::Quote(exception.what());
+	}
+
+	line << "}";
+	return line.str();
+}
+
+/**
+ * Solves every puzzle on a worker pool and prints one result line per puzzle, in input order.
+ */
+static int RunBatch(
+	const std::vector<std::string>& inputs,
+	const std::string& catalogFile,
+	std::string_view solverName,
+	const TCSolver::Solver::Options& options,
+	std::chrono::milliseconds timeLimit,
+	TCSolver::Solver::SolutionCache* cache,
+	bool bStats
+) {
+	std::vector<std::string> files;
+	for (const std::string& input : inputs) {
+		if (!std::filesystem::is_directory(input)) {
+			files.push_back(input);
+			continue;
+		}
+
+		std::vector<std::string> directoryFiles;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(input)) {
+			std::filesystem::path extension = entry.path().extension();
+			if (entry.is_regular_file() && (extension == ".yaml" || extension == ".yml"))
+				directoryFiles.push_back(entry.path().string());
+		}
+		std::sort(directoryFiles.begin(), directoryFiles.end());
+		files.insert(files.end(), directoryFiles.begin(), directoryFiles.end());
+	}
+
+	std::shared_ptr<TCSolver::Catalog> catalog;
+	if (!catalogFile.empty()) {
+		catalog = std::make_shared<TCSolver::Catalog>();
+		catalog->Load(catalogFile);
+	}
+
+	// Puzzles are spread over the pool, so each one is solved on a single thread
+	TCSolver::Solver::Options puzzleOptions = options;
+	puzzleOptions.threadCount = 1;
+
+	std::vector<std::string> lines(files.size());
+	std::vector<uint8_t> bDone(files.size(), false);
+	size_t nextLine = 0;
+	std::mutex outputMutex;
+
+	TCSolver::ThreadPool pool(options.threadCount);
+	pool.ParallelFor(files.size(), [&](size_t i) {
+		std::string line = SolveFile(files[i], catalog, solverName, puzzleOptions, timeLimit, cache, bStats);
+
+		std::lock_guard lock(outputMutex);
+		lines[i] = std::move(line);
+		bDone[i] = true;
+		for (; nextLine < files.size() && bDone[nextLine]; ++nextLine) {
+			std::cout << lines[nextLine] << "\n";
+			lines[nextLine].clear();
+		}
+	});
+
+	std::cout.flush();
+	return 0;
+}
+
+/**
+ * Loads every catalog once, then answers requests on stdin (address "-") or a Unix domain socket.
+ */
+static int RunDaemon(
+	const std::string& address,
+	const std::vector<std::string>& catalogFiles,
+	std::string_view solverName,
+	const TCSolver::Solver::Options& options,
+	std::chrono::milliseconds timeout,
+	TCSolver::Solver::SolutionCache* cache,
+	bool bStats
+) {
+	TCSolver::Daemon::Settings settings;
+	settings.solverName = solverName;
+	settings.threadCount = options.threadCount;
+	settings.timeout = timeout;
+	settings.cache = cache;
+	settings.bStats = bStats;
+	settings.bBoundedMemory = options.bBoundedMemory;
+	settings.bAnytime = options.bAnytime;
+
+	// Requests name a catalog by its file name without the extension. The first one is the default.
+	for (const std::string& catalogFile : catalogFiles) {
+		auto catalog = std::make_shared<TCSolver::Catalog>();
+		catalog->Load(catalogFile);
+		if (!settings.defaultCatalog) settings.defaultCatalog = catalog;
+		settings.catalogs[std::filesystem::path(catalogFile).stem().string()] = std::move(catalog);
+	}
+
+	TCSolver::Daemon daemon(std::move(settings));
+	if (address == "-") daemon.ServeStream();
+	else daemon.ServeSocket(address);
+	return 0;
+}
 
 int main(int argc, char* argv[]) {
-	if (argc != 2) {
-		std::cerr << "Usage: " << argv[0] << " <config file>" << std::endl;
+	TCSolver::Solver::Options options;
+	std::vector<std::string> inputs;
+	std::vector<std::string> catalogFiles;
+	std::string cacheFile;
+	std::string serveAddress;
+	std::chrono::milliseconds timeout = std::chrono::milliseconds::zero();
+	std::chrono::milliseconds timeLimit = std::chrono::milliseconds::zero();
+	std::string_view solverName = "dijkstra-steiner";
+	bool bBatch = false;
+	bool bStats = false;
+	bool bValid = true;
+
+	for (int32_t i = 1; i < argc; ++i) {
+		std::string_view argument = argv[i];
+		if (argument == "--threads" && i + 1 < argc) {
+			options.threadCount = std::max(1, std::atoi(argv[++i]));
+		} else if (argument == "--solver" && i + 1 < argc) {
+			solverName = argv[++i];
+		} else if (argument == "--catalog" && i + 1 < argc) {
+			catalogFiles.emplace_back(argv[++i]);
+		} else if (argument == "--cache" && i + 1 < argc) {
+			cacheFile = argv[++i];
+		} else if (argument == "--serve" && i + 1 < argc) {
+			serveAddress = argv[++i];
+		} else if (argument == "--timeout" && i + 1 < argc) {
+			timeout = std::chrono::milliseconds(std::max(0, std::atoi(argv[++i])));
+		} else if (argument == "--time-limit" && i + 1 < argc) {
+			timeLimit = std::chrono::milliseconds(std::max(0, std::atoi(argv[++i])));
+			options.bAnytime = timeLimit > std::chrono::milliseconds::zero();
+		} else if (argument == "--compile-catalog" && i + 2 < argc) {
+			TCSolver::Catalog::Compile(argv[i + 1], argv[i + 2]);
+			return 0;
+		} else if (argument == "--batch") {
+			bBatch = true;
+		} else if (argument == "--stats") {
+			bStats = true;
+		} else if (argument == "--bounded-memory") {
+			options.bBoundedMemory = true;
+		} else if (!argument.starts_with("--")) {
+			inputs.emplace_back(argument);
+		} else {
+			bValid = false;
+			break;
+		}
+	}
+
+	// Only the daemon picks between several catalogs, and only it has a timeout. Single puzzles take a time limit.
+	bValid = bValid
+		&& (serveAddress.empty()
+			? !inputs.empty() && catalogFiles.size() <= 1 && timeout == std::chrono::milliseconds::zero()
+			: inputs.empty())
+		&& std::find(TCSolver::Solver::SOLVER_NAMES.begin(), TCSolver::Solver::SOLVER_NAMES.end(), solverName)
+			!= TCSolver::Solver::SOLVER_NAMES.end();
+
+	if (!bValid) {
+		std::cerr
+			<< "Usage: " << argv[0]
+			<< " [--threads <count>] [--solver dijkstra-steiner|dreyfus-wagner|heuristic] [--catalog <file>]"
+			<< " [--cache <file>] [--batch] [--stats] [--bounded-memory] [--time-limit <ms>]"
+			<< " <config file or directory>..."
+			<< "\n       " << argv[0]
+			<< " --serve <socket path or -> [--threads <count>] [--solver <name>] [--catalog <file>]..."
+			<< " [--cache <file>] [--timeout <ms> | --time-limit <ms>] [--stats] [--bounded-memory]"
+			<< "\n       " << argv[0] << " --compile-catalog <catalog yaml> <binary catalog>"
+			<< std::endl;
 		return 1;
 	}
 
-	std::string configFile = argv[1];
+	std::unique_ptr<TCSolver::Solver::SolutionCache> cache;
+	if (!cacheFile.empty()) cache = std::make_unique<TCSolver::Solver::SolutionCache>(cacheFile);
+
+	if (!serveAddress.empty()) {
+		// A time limit is a timeout that answers with the best tree so far instead of none
+		if (options.bAnytime) timeout = timeLimit;
+		return RunDaemon(serveAddress, catalogFiles, solverName, options, timeout, cache.get(), bStats);
+	}
+
+	const std::string catalogFile = catalogFiles.empty() ? std::string() : catalogFiles.front();
+
+	if (bBatch || inputs.size() > 1 || std::filesystem::is_directory(inputs.front()))
+		return RunBatch(inputs, catalogFile, solverName, options, timeLimit, cache.get(), bStats);
+
+	std::shared_ptr<TCSolver::Catalog> catalog;
+	if (!catalogFile.empty()) {
+		catalog = std::make_shared<TCSolver::Catalog>();
+		catalog->Load(catalogFile);
+	}
 
 	TCSolver::Config config;
-	config.Parse(configFile);
+	config.Parse(inputs.front(), catalog);
 	config.Print();
 
 	TCSolver::Graph graph(config);
-	for (const TCSolver::Node& terminal : config.GetTerminals()) {
-		graph.Add(terminal.GetPosition(), terminal.GetAspectId());
-		if (terminal.GetAspectId() == -1) continue;
-		graph.AddTerminals({terminal.GetPosition()});
-	}
+	TCSolver::Solver::AddNodes(graph, config);
 	graph.Print();
 
-	int32_t terminals = graph.GetTerminals().size();
-	if (terminals <= 0) {
+	if (graph.GetTerminals().empty()) {
 		std::cerr << "Not enough terminals" << std::endl;
 		return 1;
-	} else if (terminals == 1) {
-		// TODO: explore just the neighbors and choose the cheapest
-	} else if (terminals == 2) {
-		std::vector<TCSolver::AStar::State> solution;
-
-		auto start = std::chrono::high_resolution_clock::now();
-
-		bool bSuccess = TCSolver::AStar::Solve(graph,
-			*graph.GetTerminals().cbegin(),
-			*(++graph.GetTerminals().cbegin()),
-			solution
-		);
-
-		auto end = std::chrono::high_resolution_clock::now();
-
-		if (!bSuccess) {
-			std::cerr
-				<< "No solution found (took "
-				<< std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-				<< ")"
-				<< std::endl;
-			return 0;
-		}
+	}
 
-		std::cout
-			<< "Solution found in "
-			<< std::chrono::duration_cast<std::chrono::microseconds>(end - start)
-			<< ": "
-			<< std::endl;
+	if (options.bAnytime) options.deadline = std::chrono::steady_clock::now() + timeLimit;
+	TCSolver::Solver::Solution solution = TCSolver::Solver::Solve(graph, solverName, options, cache.get());
+	if (solution.stats.bFallback)
+		std::cerr << "Warning: " << solverName << " gave no answer, falling back to the heuristic" << std::endl;
 
-		for (const TCSolver::AStar::State& state : solution) {
-			if (!graph.IsTerminal(state.position)) graph.Add(state.position, state.aspectId);
-		}
+	if (bStats) {
+		TCSolver::Solver::WriteJson(std::cout, solution.stats);
+		std::cout << std::endl;
+	}
 
-		graph.Print();
-	} else if (terminals <= 15) {
-		auto start = std::chrono::high_resolution_clock::now();
+	if (!solution.bSolved) {
+		std::cerr << "No solution found (took " << solution.stats.time << ")" << std::endl;
+		return 0;
+	}
 
-		bool bSuccess = TCSolver::DreyfusWagner::Solve(graph);
+	std::cout
+		<< "Solution found in " << solution.stats.time
+		<< " using " << solution.stats.solver << (solution.stats.bCached ? " (cached)" : "")
+		<< " (cost " << solution.cost;
+	if (solution.lowerBound >= 0) std::cout << ", lower bound " << solution.lowerBound;
+	std::cout << "): " << std::endl;
 
-		auto end = std::chrono::high_resolution_clock::now();
+	for (const TCSolver::Solver::Placement& placement : solution.placements)
+		graph.Add(placement.position, placement.aspectId);
 
-		std::cout
-			<< "Solution found in "
-			<< std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
-			<< ": "
-			<< std::endl;
-		// for (const TCSolver::DreyfusWagner::State& state : solution) {
-		// 	if (!graph.IsTerminal(state.position)) graph.Add(state.position, state.aspectId);
-		// }
-		// graph.Print();
-	} else {
-		std::cerr << "Too many terminals" << std::endl;
-		return 1;
-	}
+	graph.Print();
 }
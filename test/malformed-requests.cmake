@@ -0,0 +1,22 @@
+# Feeds test/malformed-requests.jsonl to a daemon on stdin. Every malformed request has to come back as an error line,
+# and the daemon has to live on to solve the well-formed request after them.
+execute_process(
+	COMMAND "${SOLVER}" --serve -
+	INPUT_FILE "${CMAKE_CURRENT_LIST_DIR}/malformed-requests.jsonl"
+	OUTPUT_VARIABLE output
+	RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "The daemon exited with ${result}:\n${output}")
+endif()
+
+foreach(id 1 2 3 4)
+	if(NOT output MATCHES "{\"id\":${id},\"solved\":false,\"error\":")
+		message(FATAL_ERROR "Request ${id} was not rejected:\n${output}")
+	endif()
+endforeach()
+
+if(NOT output MATCHES "{\"id\":5,\"solved\":true")
+	message(FATAL_ERROR "Request 5 was not solved:\n${output}")
+endif()